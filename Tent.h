@@ -1,5 +1,17 @@
 #pragma once
 #include "src/Entity.h"
+#include "src/AlignedAllocator.h"
+#include "src/MappedVector.h"
 #include "src/ComponentStorage.h"
+#include "src/ComponentIndex.h"
+#include "src/Hierarchy.h"
+#include "src/MemoryStats.h"
+#include "src/Profiler.h"
+#include "src/AccessChecker.h"
+#include "src/DoubleBuffer.h"
 #include "src/Registry.h"
+#include "src/StaticRegistry.h"
 #include "src/View.h"
+#include "src/RuntimeView.h"
+#include "src/AsyncLoader.h"
+#include "src/Simulation.h"
@@ -2,7 +2,13 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 #include <vector>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <thread>
 
 #include "../Tent.h"
 
@@ -72,6 +78,48 @@ namespace RegistryTesting_Class
 		TestComponentSix& operator=(TestComponentSix&& o) noexcept { this->id = o.id; return *this; }
 	};
 
+	struct TestCopyableComponent
+	{
+		int id{ 0 };
+		TestCopyableComponent() = default;
+		TestCopyableComponent(int _id) : id(_id) {}
+	};
+
+	struct TestMappedComponent
+	{
+		int id{ 0 };
+		float value{ 0.0f };
+	};
+
+	struct alignas(32) TestSimdComponent
+	{
+		float lanes[8]{};
+	};
+
+	struct TestPaddedComponent
+	{
+		int id{ 0 };
+		TestPaddedComponent() = default;
+		TestPaddedComponent(int _id) : id(_id) {}
+	};
+}
+
+namespace tent
+{
+	template<>
+	struct storage_traits<RegistryTesting_Class::TestPaddedComponent> : aligned_storage_traits<RegistryTesting_Class::TestPaddedComponent, 64> {};
+
+	template<>
+	struct storage_traits<RegistryTesting_Class::TestMappedComponent>
+	{
+		using container_type = MappedVector<RegistryTesting_Class::TestMappedComponent>;
+	};
+}
+
+namespace RegistryTesting_Class
+{
+	using namespace tent;
+
 	void createEntitiesComponents(Registry& reg, std::size_t amount, Entity* _array = nullptr)
 	{
 		for (std::size_t i = 0; i < amount; i++)
@@ -248,6 +296,53 @@ namespace RegistryTesting_Class
 		ASSERT_EQ(true, reg.exists<TestComponentSix>(e3) == false);
 	}
 
+	TEST(RegistryTesting, RegistryTestingTryGet)
+	{
+		TestRegistry reg;
+		tent::Entity e1 = reg.createEntity();
+		tent::Entity e2 = reg.createEntity();
+
+		reg.emplace_back<TestComponentOne>(e1, 10);
+		reg.emplace_back<TestComponentOne>(e2, 20);
+		reg.emplace_back<TestComponentTwo>(e2, 21);
+
+		ASSERT_EQ(true, reg.try_get<TestComponentOne>(e1) != nullptr);
+		ASSERT_EQ(true, reg.try_get<TestComponentOne>(e1)->id == 10);
+		ASSERT_EQ(true, reg.try_get<TestComponentTwo>(e1) == nullptr);
+		ASSERT_EQ(true, reg.try_get<TestComponentTwo>(e2)->id == 21);
+		//pool for TestComponentSix has never been created.
+		ASSERT_EQ(true, reg.try_get<TestComponentSix>(e1) == nullptr);
+
+		ASSERT_EQ(true, reg.get_unchecked<TestComponentOne>(e2).id == 20);
+
+		reg.remove<TestComponentTwo>(e2);
+		ASSERT_EQ(true, reg.try_get<TestComponentTwo>(e2) == nullptr);
+	}
+
+	TEST(RegistryTesting, RegistryTestingMultiGet)
+	{
+		TestRegistry reg;
+		tent::Entity e1 = reg.createEntity();
+		tent::Entity e2 = reg.createEntity();
+
+		reg.emplace_back<TestComponentOne>(e1, 1);
+		reg.emplace_back<TestComponentTwo>(e1, 2);
+		reg.emplace_back<TestComponentThree>(e1, 3);
+		reg.emplace_back<TestComponentOne>(e2, 4);
+
+		auto [c1, c2, c3] = reg.get<TestComponentOne, TestComponentTwo, TestComponentThree>(e1);
+		ASSERT_EQ(true, c1.id == 1);
+		ASSERT_EQ(true, c2.id == 2);
+		ASSERT_EQ(true, c3.id == 3);
+		//references point into the pools.
+		c2.id = 20;
+		ASSERT_EQ(true, reg.get<TestComponentTwo>(e1).id == 20);
+
+		auto [p1, p2] = reg.try_get<TestComponentOne, TestComponentTwo>(e2);
+		ASSERT_EQ(true, p1 != nullptr && p1->id == 4);
+		ASSERT_EQ(true, p2 == nullptr);
+	}
+
 	TEST(RegistryTesting, RegistryTestingView)
 	{
 		TestRegistry reg;
@@ -297,6 +392,1011 @@ namespace RegistryTesting_Class
 		ASSERT_EQ(true, reg.exists<TestComponentOne>(e3) == false);
 	}
 
+	TEST(RegistryTesting, RegistryTestingViewExclude)
+	{
+		TestRegistry reg;
+		tent::Entity e1 = reg.createEntity();
+		tent::Entity e2 = reg.createEntity();
+		tent::Entity e3 = reg.createEntity();
+		tent::Entity e4 = reg.createEntity();
+
+		reg.emplace_back<TestComponentOne>(e1, 1);
+		reg.emplace_back<TestComponentTwo>(e1, 1);
+
+		reg.emplace_back<TestComponentOne>(e2, 2);
+		reg.emplace_back<TestComponentTwo>(e2, 2);
+		reg.emplace_back<TestComponentThree>(e2, 2);
+
+		reg.emplace_back<TestComponentOne>(e3, 3);
+		reg.emplace_back<TestComponentTwo>(e3, 3);
+		reg.emplace_back<TestComponentFour>(e3, 3);
+
+		reg.emplace_back<TestComponentOne>(e4, 4);
+
+		std::vector<int> seen;
+		auto view = reg.view<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentThree, TestComponentFour>);
+		for (auto e : view)
+		{
+			seen.push_back(view.get<TestComponentOne>(e).id);
+		}
+		ASSERT_EQ(true, seen.size() == 1);
+		ASSERT_EQ(true, seen[0] == 1);
+
+		//excluding a Component that has no pool yet filters nothing.
+		seen.clear();
+		auto other = reg.view<TestComponentOne>(tent::exclude<TestComponentSix>);
+		for (auto e : other)
+		{
+			seen.push_back(other.get<TestComponentOne>(e).id);
+		}
+		ASSERT_EQ(true, seen.size() == 4);
+
+		//creating views does not use up entity ids.
+		tent::Entity before = reg.createEntity();
+		for (int i = 0; i < 100; i++) reg.view<TestComponentOne>(tent::exclude<TestComponentThree>);
+		tent::Entity after = reg.createEntity();
+		ASSERT_EQ(true, getEntityIndex(after) == getEntityIndex(before) + 1);
+	}
+
+	TEST(RegistryTesting, RegistryTestingRuntimeView)
+	{
+		TestRegistry reg;
+		tent::Entity e1 = reg.createEntity();
+		tent::Entity e2 = reg.createEntity();
+		tent::Entity e3 = reg.createEntity();
+
+		reg.emplace_back<TestComponentOne>(e1, 1);
+		reg.emplace_back<TestComponentTwo>(e1, 1);
+
+		reg.emplace_back<TestComponentOne>(e2, 2);
+		reg.emplace_back<TestComponentTwo>(e2, 2);
+		reg.emplace_back<TestComponentThree>(e2, 2);
+
+		reg.emplace_back<TestComponentOne>(e3, 3);
+
+		std::size_t one = reg.index<TestComponentOne>();
+		std::size_t two = reg.index<TestComponentTwo>();
+		std::size_t three = reg.index<TestComponentThree>();
+
+		std::vector<int> seen;
+		auto view = reg.runtime_view({ one, two }, { three });
+		ASSERT_EQ(true, view.componentSize(one) == sizeof(TestComponentOne));
+		ASSERT_EQ(true, view.componentAlignment(two) == alignof(TestComponentTwo));
+		for (auto e : view)
+		{
+			auto* c1 = static_cast<TestComponentOne*>(view.get(one, e));
+			auto* c2 = static_cast<TestComponentTwo*>(view.get(two, e));
+			ASSERT_EQ(true, c1->id == c2->id);
+			seen.push_back(c1->id);
+		}
+		ASSERT_EQ(true, seen.size() == 1);
+		ASSERT_EQ(true, seen[0] == 1);
+
+		//a required Component without a pool matches nothing.
+		auto none = reg.runtime_view({ one, reg.index<TestComponentSix>() });
+		ASSERT_EQ(true, none.begin() == none.end());
+	}
+
+	TEST(RegistryTesting, RegistryTestingHierarchy)
+	{
+		TestRegistry reg;
+		tent::Entity root = reg.createEntity();
+		tent::Entity a = reg.createEntity();
+		tent::Entity b = reg.createEntity();
+		tent::Entity a1 = reg.createEntity();
+		tent::Entity a2 = reg.createEntity();
+		tent::Entity b1 = reg.createEntity();
+
+		//attach children in an order that leaves the pool unsorted.
+		reg.setParent(b1, b);
+		reg.setParent(a2, a);
+		reg.setParent(a1, a);
+		reg.setParent(b, root);
+		reg.setParent(a, root);
+
+		ASSERT_EQ(true, reg.get<Relationship>(a1).parent == a);
+		ASSERT_EQ(true, reg.get<Relationship>(root).firstChild == a);
+		ASSERT_EQ(true, reg.get<Relationship>(a).nextSibling == b);
+
+		reg.sortHierarchy();
+		std::vector<tent::Entity> order;
+		auto view = reg.view<Relationship>();
+		for (auto e : view)
+		{
+			auto& r = view.get<Relationship>(e);
+			//every parent has to be visited before its children.
+			if (!(r.parent == ENTITY_NULL_ID))
+			{
+				ASSERT_EQ(true, std::find(order.begin(), order.end(), r.parent) != order.end());
+			}
+			order.push_back(e);
+		}
+		ASSERT_EQ(true, order.size() == 6);
+		ASSERT_EQ(true, order[0] == root);
+		ASSERT_EQ(true, order[1] == a && order[2] == a1 && order[3] == a2);
+		ASSERT_EQ(true, order[4] == b && order[5] == b1);
+
+		//killing an entity detaches it and turns its children into roots.
+		reg.kill(a);
+		ASSERT_EQ(true, reg.get<Relationship>(root).firstChild == b);
+		ASSERT_EQ(true, reg.get<Relationship>(a1).parent == ENTITY_NULL_ID);
+		ASSERT_EQ(true, reg.get<Relationship>(a2).parent == ENTITY_NULL_ID);
+
+		reg.removeParent(b);
+		ASSERT_EQ(true, reg.get<Relationship>(root).firstChild == ENTITY_NULL_ID);
+		ASSERT_EQ(true, reg.get<Relationship>(b1).parent == b);
+
+		//removing a Relationship detaches it the same way.
+		reg.remove<Relationship>(b1);
+		ASSERT_EQ(true, reg.get<Relationship>(b).firstChild == ENTITY_NULL_ID);
+		reg.setParent(a1, root);
+		reg.setParent(a2, root);
+		reg.remove<Relationship>(a2);
+		ASSERT_EQ(true, reg.get<Relationship>(root).firstChild == a1);
+		ASSERT_EQ(true, reg.get<Relationship>(a1).nextSibling == ENTITY_NULL_ID);
+		reg.sortHierarchy();
+		reg.clear<Relationship>();
+		reg.setParent(a1, root);
+		reg.sortHierarchy();
+		ASSERT_EQ(true, reg.get<Relationship>(root).firstChild == a1);
+	}
+
+	TEST(RegistryTesting, RegistryTestingMergeExtract)
+	{
+		TestRegistry reg;
+		tent::Entity e1 = reg.createEntity();
+		reg.emplace_back<TestComponentOne>(e1, 1);
+
+		TestRegistry chunk;
+		tent::Entity c1 = chunk.createEntity();
+		tent::Entity c2 = chunk.createEntity();
+		tent::Entity c3 = chunk.createEntity();
+		chunk.emplace_back<TestComponentOne>(c1, 11);
+		chunk.emplace_back<TestComponentOne>(c2, 12);
+		chunk.emplace_back<TestComponentTwo>(c2, 22);
+		chunk.emplace_back<TestComponentThree>(c3, 33);
+		chunk.setParent(c2, c1);
+
+		reg.merge(chunk);
+		ASSERT_EQ(true, chunk.exists(c1) == false);
+		ASSERT_EQ(true, reg.exists(c1) && reg.exists(c2) && reg.exists(c3));
+		ASSERT_EQ(true, reg.get<TestComponentOne>(e1).id == 1);
+		ASSERT_EQ(true, reg.get<TestComponentOne>(c1).id == 11);
+		ASSERT_EQ(true, reg.get<TestComponentTwo>(c2).id == 22);
+		ASSERT_EQ(true, reg.get<TestComponentThree>(c3).id == 33);
+		ASSERT_EQ(true, reg.get<Relationship>(c2).parent == c1);
+
+		//c3 is listed twice but only moved once.
+		std::vector<tent::Entity> toExtract{ c2, c3, c3 };
+		TestRegistry out = reg.extract(toExtract);
+		ASSERT_EQ(true, reg.exists(c2) == false && reg.exists(c3) == false);
+		ASSERT_EQ(true, reg.exists<TestComponentOne>(c2) == false);
+		ASSERT_EQ(true, out.exists(c2) && out.exists(c3));
+		ASSERT_EQ(true, out.get<TestComponentOne>(c2).id == 12);
+		ASSERT_EQ(true, out.get<TestComponentTwo>(c2).id == 22);
+		ASSERT_EQ(true, out.get<TestComponentThree>(c3).id == 33);
+		//the link to c1 was cut because c1 stayed behind.
+		ASSERT_EQ(true, out.get<Relationship>(c2).parent == ENTITY_NULL_ID);
+		ASSERT_EQ(true, reg.get<Relationship>(c1).firstChild == ENTITY_NULL_ID);
+		ASSERT_EQ(true, reg.get<TestComponentOne>(c1).id == 11);
+		ASSERT_EQ(true, out.memoryStats().entities == 2);
+
+		//entities spread over the pools leave in one range per pool and keep their Components.
+		std::vector<tent::Entity> many;
+		std::vector<tent::Entity> picked;
+		for (int i = 0; i < 100; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, 100 + i);
+			if (i % 2 == 0) reg.emplace_back<TestComponentTwo>(e, 100 + i);
+			many.push_back(e);
+			if (i % 3 == 0) picked.push_back(e);
+		}
+		TestRegistry rest = reg.extract(picked);
+		for (int i = 0; i < 100; i++)
+		{
+			TestRegistry& owner = i % 3 == 0 ? rest : reg;
+			ASSERT_EQ(true, owner.get<TestComponentOne>(many[i]).id == 100 + i);
+			ASSERT_EQ(true, owner.exists<TestComponentTwo>(many[i]) == (i % 2 == 0));
+			if (i % 2 == 0) ASSERT_EQ(true, owner.get<TestComponentTwo>(many[i]).id == 100 + i);
+		}
+		ASSERT_EQ(true, rest.memoryStats().entities == 34);
+	}
+
+	TEST(RegistryTesting, RegistryTestingMemoryStats)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 100; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			entities.push_back(e);
+		}
+		for (int i = 0; i < 60; i++)
+		{
+			reg.kill(entities[i]);
+		}
+
+		tent::RegistryMemoryStats stats = reg.memoryStats();
+		ASSERT_EQ(true, stats.entities == 40);
+		ASSERT_EQ(true, stats.peakEntities == 100);
+		ASSERT_EQ(true, stats.recycleableEntities == 60);
+		ASSERT_EQ(true, stats.bookkeepingBytes > 0);
+		ASSERT_EQ(true, stats.pools.size() == 1);
+
+		const tent::PoolMemoryStats& pool = stats.pools[0];
+		ASSERT_EQ(true, pool.componentId == reg.index<TestComponentOne>());
+		ASSERT_EQ(true, pool.size == 40);
+		ASSERT_EQ(true, pool.peak == 100);
+		ASSERT_EQ(true, pool.componentBytes == 40 * sizeof(TestComponentOne));
+		ASSERT_EQ(true, pool.componentCapacityBytes >= 100 * sizeof(TestComponentOne));
+		ASSERT_EQ(true, pool.slackBytes() > 0);
+		ASSERT_EQ(true, stats.capacityBytes() > stats.slackBytes());
+
+		//recycled ids handed over by merge can raise the peak.
+		TestRegistry other;
+		for (int i = 0; i < 10; i++)
+		{
+			tent::Entity e = other.createEntity();
+			other.kill(e);
+		}
+		reg.merge(other);
+		for (int i = 0; i < 70; i++) reg.createEntity();
+		ASSERT_EQ(true, reg.memoryStats().recycleableEntities == 0);
+		ASSERT_EQ(true, reg.memoryStats().peakEntities == 110);
+	}
+
+	TEST(RegistryTesting, RegistryTestingCompact)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 1000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			entities.push_back(e);
+		}
+		//kill the newest entities so the largest indices are freed.
+		for (int i = 10; i < 1000; i++)
+		{
+			reg.kill(entities[i]);
+		}
+
+		tent::PoolMemoryStats before = reg.memoryStats().pools[0];
+		reg.compact();
+		tent::PoolMemoryStats after = reg.memoryStats().pools[0];
+		ASSERT_EQ(true, after.size == 10);
+		ASSERT_EQ(true, after.componentCapacityBytes < before.componentCapacityBytes);
+		ASSERT_EQ(true, after.sparseCapacityBytes < before.sparseCapacityBytes);
+		for (int i = 0; i < 10; i++)
+		{
+			ASSERT_EQ(true, reg.get<TestComponentOne>(entities[i]).id == i);
+		}
+
+		//the lowest freed index is reused first.
+		tent::Entity reused = reg.createEntity();
+		ASSERT_EQ(true, getEntityIndex(reused) == getEntityIndex(entities[10]));
+		reg.emplace_back<TestComponentOne>(reused, 10);
+		ASSERT_EQ(true, reg.get<TestComponentOne>(reused).id == 10);
+	}
+
+	TEST(RegistryTesting, RegistryTestingProfilerTrace)
+	{
+		tent::Profiler& profiler = tent::Profiler::instance();
+		profiler.clear();
+		int owner{ 0 };
+		{
+			tent::ProfileScope scope("Test::scope", &owner);
+			profiler.counter("Test::counter", &owner, 42.0);
+		}
+		ASSERT_EQ(true, profiler.size() == 2);
+
+		const char* path = "tent_profiler_test.json";
+		ASSERT_EQ(true, profiler.writeChromeTrace(path));
+		std::ifstream in(path);
+		std::string trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+		std::remove(path);
+		ASSERT_EQ(true, trace.find("\"traceEvents\"") != std::string::npos);
+		ASSERT_EQ(true, trace.find("\"Test::scope\"") != std::string::npos);
+		ASSERT_EQ(true, trace.find("\"ph\":\"X\"") != std::string::npos);
+		ASSERT_EQ(true, trace.find("\"ph\":\"C\"") != std::string::npos);
+		profiler.clear();
+	}
+
+	TEST(RegistryTesting, RegistryTestingCachedView)
+	{
+		TestRegistry reg;
+		tent::Entity e1 = reg.createEntity();
+		tent::Entity e2 = reg.createEntity();
+		reg.emplace_back<TestComponentOne>(e1, 1);
+		reg.emplace_back<TestComponentTwo>(e1, 1);
+		reg.emplace_back<TestComponentOne>(e2, 2);
+
+		auto& view = reg.cachedView<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentFive>);
+		std::size_t count{ 0 };
+		for (auto e : view) count++;
+		ASSERT_EQ(true, count == 1);
+
+		//the same view is handed out again and sees entities added since.
+		reg.emplace_back<TestComponentTwo>(e2, 2);
+		auto& again = reg.cachedView<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentFive>);
+		ASSERT_EQ(true, &view == &again);
+		count = 0;
+		for (auto e : again) count++;
+		ASSERT_EQ(true, count == 2);
+
+		//an excluded pool that was empty when the view was built is respected once it fills.
+		reg.emplace_back<TestComponentFive>(e1, 1);
+		count = 0;
+		for (auto e : reg.cachedView<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentFive>))
+		{
+			ASSERT_EQ(true, e == e2);
+			count++;
+		}
+		ASSERT_EQ(true, count == 1);
+
+		//a different query gets its own view. removals happen on the next fetch.
+		auto& other = reg.cachedView<TestComponentOne, TestComponentTwo>();
+		ASSERT_EQ(true, &other != &view);
+		for (auto e : other)
+		{
+			ASSERT_EQ(true, other.get<TestComponentOne>(e).id == other.get<TestComponentTwo>(e).id);
+			other.remove(e);
+		}
+		ASSERT_EQ(true, reg.exists<TestComponentOne>(e1));
+		reg.cachedView<TestComponentOne, TestComponentTwo>();
+		ASSERT_EQ(true, reg.exists<TestComponentOne>(e1) == false);
+		ASSERT_EQ(true, reg.exists<TestComponentTwo>(e2) == false);
+	}
+
+	TEST(RegistryTesting, RegistryTestingViewChunks)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 10; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			reg.emplace_back<TestComponentTwo>(e, i * 2);
+			entities.push_back(e);
+		}
+		reg.emplace_back<TestComponentThree>(entities[4], 0);
+
+		//both pools are stored in the same order so the only break is the excluded entity.
+		std::vector<std::size_t> counts;
+		int total{ 0 };
+		auto view = reg.view<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentThree>);
+		view.chunks<TestComponentOne, TestComponentTwo>([&](const tent::Entity* es, TestComponentOne* c1, TestComponentTwo* c2, std::size_t count)
+			{
+				for (std::size_t i = 0; i < count; i++)
+				{
+					ASSERT_EQ(true, c2[i].id == c1[i].id * 2);
+					ASSERT_EQ(true, reg.get<TestComponentOne>(const_cast<tent::Entity&>(es[i])).id == c1[i].id);
+					total += c1[i].id;
+				}
+				counts.push_back(count);
+			});
+		ASSERT_EQ(true, counts.size() == 2);
+		ASSERT_EQ(true, counts[0] == 4 && counts[1] == 5);
+		ASSERT_EQ(true, total == 45 - 4);
+
+		//a single pool is handed out as one block.
+		reg.remove<TestComponentOne>(entities[7]);
+		counts.clear();
+		total = 0;
+		reg.view<TestComponentOne>().chunks<TestComponentOne>([&](const tent::Entity* es, TestComponentOne* c1, std::size_t count)
+			{
+				for (std::size_t i = 0; i < count; i++)
+				{
+					ASSERT_EQ(true, reg.read<TestComponentOne>(const_cast<tent::Entity&>(es[i])).id == c1[i].id);
+					total += c1[i].id;
+				}
+				counts.push_back(count);
+			});
+		ASSERT_EQ(true, counts.size() == 1 && counts[0] == 9);
+		ASSERT_EQ(true, total == 45 - 7);
+	}
+
+	TEST(RegistryTesting, RegistryTestingDoubleBuffer)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 3000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestCopyableComponent>(e, i);
+			entities.push_back(e);
+		}
+		reg.enableDoubleBuffer<TestCopyableComponent>();
+		auto before = reg.snapshot<TestCopyableComponent>();
+		ASSERT_EQ(true, before->size() == 3000);
+
+		//writes are not seen until they are published.
+		reg.get<TestCopyableComponent>(entities[5]).id = -5;
+		reg.kill(entities[2999]);
+		ASSERT_EQ(true, before->get(entities[5])->id == 5);
+
+		reg.publish();
+		auto after = reg.snapshot<TestCopyableComponent>();
+		ASSERT_EQ(true, after->size() == 2999);
+		ASSERT_EQ(true, after->get(entities[5])->id == -5);
+		ASSERT_EQ(true, after->get(entities[2999]) == nullptr);
+		ASSERT_EQ(true, after->get(entities[1500])->id == 1500);
+		//the old snapshot stays untouched for readers that still hold it.
+		ASSERT_EQ(true, before->get(entities[5])->id == 5);
+		ASSERT_EQ(true, before->get(entities[2999])->id == 2999);
+
+		int total{ 0 };
+		after->each([&](const tent::Entity& e, const TestCopyableComponent& c) { total++; });
+		ASSERT_EQ(true, total == 2999);
+	}
+
+	TEST(RegistryTesting, RegistryTestingChangeTicks)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 5; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			reg.emplace_back<TestComponentTwo>(e, i);
+			entities.push_back(e);
+		}
+		//everything was added before the system first ran.
+		uint32_t lastRun{ 0 };
+		uint32_t since = lastRun;
+		lastRun = reg.advanceTick();
+		int count{ 0 };
+		for (auto e : reg.view<TestComponentOne, tent::Changed<TestComponentTwo>>(since)) count++;
+		ASSERT_EQ(true, count == 5);
+
+		//another system runs. read does not mark a Component as changed but get and patch do.
+		reg.advanceTick();
+		ASSERT_EQ(true, reg.read<TestComponentTwo>(entities[0]).id == 0);
+		reg.get<TestComponentTwo>(entities[1]).id = 10;
+		reg.patch<TestComponentTwo>(entities[3], [](TestComponentTwo& c) { c.id = 30; });
+		tent::Entity added = reg.createEntity();
+		reg.emplace_back<TestComponentOne>(added, 5);
+		reg.emplace_back<TestComponentTwo>(added, 5);
+		//removing an entity swaps its ticks along with it.
+		reg.kill(entities[2]);
+
+		since = lastRun;
+		lastRun = reg.advanceTick();
+		std::vector<int> changed;
+		for (auto e : reg.view<TestComponentOne, tent::Changed<TestComponentTwo>>(since)) changed.push_back(reg.read<TestComponentTwo>(e).id);
+		std::sort(changed.begin(), changed.end());
+		ASSERT_EQ(true, changed.size() == 3);
+		ASSERT_EQ(true, changed[0] == 5 && changed[1] == 10 && changed[2] == 30);
+
+		count = 0;
+		for (auto e : reg.view<tent::Added<TestComponentOne>>(since))
+		{
+			ASSERT_EQ(true, e == added);
+			count++;
+		}
+		ASSERT_EQ(true, count == 1);
+
+		//nothing changed since the last run.
+		reg.advanceTick();
+		auto& cached = reg.cachedView<tent::Changed<TestComponentTwo>>(lastRun);
+		ASSERT_EQ(true, cached.begin() == cached.end());
+		reg.patch<TestComponentTwo>(entities[4]);
+		count = 0;
+		for (auto e : reg.cachedView<tent::Changed<TestComponentTwo>>(lastRun))
+		{
+			ASSERT_EQ(true, e == entities[4]);
+			count++;
+		}
+		ASSERT_EQ(true, count == 1);
+
+		//merged Components are added during the tick they are merged in, whatever tick they had before.
+		TestRegistry staging;
+		for (int i = 0; i < 5; i++)
+		{
+			tent::Entity e = staging.createEntity();
+			staging.emplace_back<TestComponentOne>(e, i);
+			staging.emplace_back<TestComponentThree>(e, i);
+		}
+		since = reg.advanceTick();
+		reg.merge(staging);
+		count = 0;
+		for (auto e : reg.view<tent::Added<TestComponentOne>>(since - 1)) count++;
+		ASSERT_EQ(true, count == 5);
+		count = 0;
+		for (auto e : reg.view<tent::Added<TestComponentThree>>(since - 1)) count++;
+		ASSERT_EQ(true, count == 5);
+	}
+
+	TEST(RegistryTesting, RegistryTestingEntityTraits)
+	{
+		//indices past the 22 bits of the default Entity keep their generation intact.
+		tent::Entity64 big((tent::Entity64::entity_type(7) << 32) | 5000000u);
+		ASSERT_EQ(true, getEntityIndex(big) == 5000000u);
+		ASSERT_EQ(true, getEntityGeneration(big) == 7u);
+		ASSERT_EQ(true, sizeof(tent::Entity64) == 8 && sizeof(tent::Entity) == 4);
+
+		tent::BasicRegistry<tent::Entity64> reg;
+		std::vector<tent::Entity64> entities;
+		for (int i = 0; i < 10; i++)
+		{
+			tent::Entity64 e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			if (i % 2 == 0) reg.emplace_back<TestComponentTwo>(e, i);
+			entities.push_back(e);
+		}
+		reg.setParent(entities[1], entities[0]);
+		ASSERT_EQ(true, reg.get<tent::BasicRelationship<tent::Entity64>>(entities[1]).parent == entities[0]);
+		reg.kill(entities[0]);
+		ASSERT_EQ(true, isNullEntity(reg.get<tent::BasicRelationship<tent::Entity64>>(entities[1]).parent));
+
+		int count{ 0 };
+		for (auto e : reg.view<TestComponentOne, TestComponentTwo>())
+		{
+			ASSERT_EQ(true, reg.get<TestComponentOne>(e).id % 2 == 0);
+			count++;
+		}
+		ASSERT_EQ(true, count == 4);
+	}
+
+	TEST(RegistryTesting, RegistryTestingSimulation)
+	{
+		tent::SimulationConfig config;
+		config.entities = 500;
+		config.frames = 200;
+		config.warmupFrames = 10;
+		config.spawnPerFrame = 20;
+		config.killPerFrame = 20;
+		std::size_t runs{ 0 };
+		tent::Simulation<tent::Entity> sim(config);
+		sim.addComponent<TestComponentOne>(1.0f).addComponent<TestComponentTwo>(0.5f);
+		sim.addSystem("count", [&](TestRegistry& reg)
+			{
+				for (auto e : reg.view<TestComponentOne, TestComponentTwo>()) reg.get<TestComponentOne>(e).id++;
+				runs++;
+			});
+		tent::SimulationReport report = sim.run();
+		ASSERT_EQ(true, runs == 210);
+		ASSERT_EQ(true, report.frames == 200);
+		ASSERT_EQ(true, report.p50 <= report.p99 && report.p99 <= report.max);
+		ASSERT_EQ(true, report.systems.size() == 1 && report.systems[0].name == "count");
+		ASSERT_EQ(true, report.systems[0].max <= report.max);
+		//churn is balanced so the world stays the same size.
+		ASSERT_EQ(true, report.peakEntities == 500);
+		ASSERT_EQ(true, report.peakCapacityBytes > 0);
+		ASSERT_EQ(false, report.regressed(report));
+	}
+
+	TEST(RegistryTesting, RegistryTestingViewBitmap)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 2000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			if (i % 2 == 0) reg.emplace_back<TestComponentTwo>(e, i);
+			if (i % 4 == 0) reg.emplace_back<TestComponentThree>(e, i);
+			entities.push_back(e);
+		}
+		//without bitmaps the view probes.
+		ASSERT_EQ(false, (reg.view<TestComponentOne, TestComponentTwo>().usesBitmap()));
+		reg.enableBitmap<TestComponentOne, TestComponentTwo, TestComponentThree>();
+		reg.kill(entities[10]);
+
+		int total{ 0 };
+		int count{ 0 };
+		auto view = reg.view<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentThree>);
+		ASSERT_EQ(true, view.usesBitmap());
+		for (auto e : view)
+		{
+			ASSERT_EQ(true, reg.get<TestComponentOne>(e).id % 4 == 2);
+			total += reg.get<TestComponentTwo>(e).id;
+			count++;
+		}
+		//every i % 4 == 2 except the killed 10.
+		ASSERT_EQ(true, count == 499);
+		ASSERT_EQ(true, total == 500000 - 10);
+
+		//the bitmaps follow removals.
+		reg.remove<TestComponentTwo>(entities[2]);
+		count = 0;
+		for (auto e : reg.view<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentThree>)) count++;
+		ASSERT_EQ(true, count == 498);
+
+		//iterators taken in any order stay valid, end() is often evaluated before begin().
+		auto fresh = reg.view<TestComponentOne, TestComponentTwo>(tent::exclude<TestComponentThree>);
+		auto end = fresh.end();
+		auto begin = fresh.begin();
+		ASSERT_EQ(true, std::count_if(begin, end, [](tent::Entity&) { return true; }) == 498);
+	}
+
+	TEST(RegistryTesting, RegistryTestingClone)
+	{
+		TestRegistry reg;
+		tent::Entity bullet = reg.prefabs().createEntity();
+		reg.prefabs().emplace_back<TestCopyableComponent>(bullet, 7);
+
+		//the pool is created by the first spawn and the prefab is never part of a view.
+		std::vector<tent::Entity> wave;
+		reg.spawn(bullet, 10000, std::back_inserter(wave));
+		ASSERT_EQ(true, wave.size() == 10000);
+		int count{ 0 };
+		for (auto e : reg.view<TestCopyableComponent>())
+		{
+			ASSERT_EQ(true, reg.get<TestCopyableComponent>(e).id == 7);
+			count++;
+		}
+		ASSERT_EQ(true, count == 10000);
+		ASSERT_EQ(true, reg.exists(wave[9999]) && reg.exists(bullet) == false);
+
+		//cloning inside a Registry copies everything but the hierarchy links.
+		tent::Entity parent = reg.createEntity();
+		reg.setParent(wave[0], parent);
+		reg.get<TestCopyableComponent>(wave[0]).id = 3;
+		std::vector<tent::Entity> copies;
+		reg.clone(wave[0], 3, std::back_inserter(copies));
+		ASSERT_EQ(true, copies.size() == 3);
+		for (auto& e : copies)
+		{
+			ASSERT_EQ(true, reg.get<TestCopyableComponent>(e).id == 3);
+			ASSERT_EQ(true, reg.exists<Relationship>(e) == false);
+		}
+		reg.kill(copies[1]);
+		ASSERT_EQ(true, reg.get<TestCopyableComponent>(copies[2]).id == 3);
+
+#ifdef NDEBUG
+		//a source with a Component that can not be copied creates nothing.
+		reg.emplace_back<TestComponentOne>(wave[1], 1);
+		std::size_t alive = reg.memoryStats().entities;
+		copies.clear();
+		reg.clone(wave[1], 3, std::back_inserter(copies));
+		ASSERT_EQ(true, copies.empty() && reg.memoryStats().entities == alive);
+#endif
+	}
+
+	TEST(RegistryTesting, RegistryTestingClear)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 1000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			reg.emplace_back<TestComponentTwo>(e, i);
+			entities.push_back(e);
+		}
+		tent::RegistryMemoryStats before = reg.memoryStats();
+
+		//clearing a single pool keeps the entities alive.
+		reg.clear<TestComponentTwo>();
+		ASSERT_EQ(true, reg.exists(entities[0]));
+		ASSERT_EQ(true, reg.exists<TestComponentTwo>(entities[0]) == false);
+		ASSERT_EQ(true, reg.get<TestComponentOne>(entities[0]).id == 0);
+
+		reg.clear();
+		ASSERT_EQ(true, reg.exists(entities[0]) == false);
+		int count{ 0 };
+		for (auto e : reg.view<TestComponentOne>()) count++;
+		ASSERT_EQ(true, count == 0);
+		//the pools keep their capacity.
+		tent::RegistryMemoryStats after = reg.memoryStats();
+		ASSERT_EQ(true, after.entities == 0 && after.recycleableEntities == 1000);
+		for (std::size_t i = 0; i < after.pools.size(); i++)
+		{
+			ASSERT_EQ(true, after.pools[i].size == 0);
+			ASSERT_EQ(true, after.pools[i].capacityBytes() == before.pools[i].capacityBytes());
+		}
+
+		//the next match reuses the same indices.
+		tent::Entity e = reg.createEntity();
+		reg.emplace_back<TestComponentOne>(e, 5);
+		ASSERT_EQ(true, getEntityIndex(e) == getEntityIndex(entities[0]));
+		ASSERT_EQ(true, reg.get<TestComponentOne>(e).id == 5);
+
+		//neither refilling the pools nor clearing them again allocates.
+		if (tent::AllocationCounter::isInstalled())
+		{
+			reg.clear();
+			entities.clear();
+			for (int i = 0; i < 1000; i++) entities.push_back(reg.createEntity());
+			std::size_t allocations = tent::AllocationCounter::count();
+			for (int i = 0; i < 1000; i++)
+			{
+				reg.emplace_back<TestComponentOne>(entities[i], i);
+				reg.emplace_back<TestComponentTwo>(entities[i], i);
+			}
+			ASSERT_EQ(true, tent::AllocationCounter::count() == allocations);
+			reg.clear();
+			ASSERT_EQ(true, tent::AllocationCounter::count() == allocations);
+		}
+	}
+
+	TEST(RegistryTesting, RegistryTestingAsyncLoader)
+	{
+		TestRegistry reg;
+		tent::Entity existing = reg.createEntity();
+		reg.emplace_back<TestComponentOne>(existing, -1);
+
+		tent::AsyncLoader<tent::Entity> loader(100);
+		ASSERT_EQ(false, loader.busy());
+		tent::Entity root;
+		loader.load([&root](TestRegistry& staging)
+			{
+				root = staging.createEntity();
+				staging.emplace_back<TestComponentOne>(root, 0);
+				for (int i = 1; i < 1000; i++)
+				{
+					tent::Entity e = staging.createEntity();
+					staging.emplace_back<TestComponentOne>(e, i);
+					if (i % 2 == 0) staging.emplace_back<TestComponentTwo>(e, i);
+					if (i < 10) staging.setParent(e, root);
+				}
+			});
+		ASSERT_EQ(true, loader.busy());
+#ifdef NDEBUG
+		//a fragment started while busy is rejected instead of replacing the pending one.
+		ASSERT_EQ(false, loader.load([](TestRegistry&) {}));
+#endif
+
+		while (!loader.decoded()) std::this_thread::yield();
+		//a budget of zero still merges one slice per call.
+		int calls{ 0 };
+		while (!loader.integrate(reg, std::chrono::microseconds(0)))
+		{
+			calls++;
+			//the hierarchy only shows up with the last slice.
+			ASSERT_EQ(true, reg.try_get<Relationship>(root) == nullptr);
+		}
+		ASSERT_EQ(true, calls == 9);
+		ASSERT_EQ(false, loader.busy());
+
+		int count{ 0 };
+		int children{ 0 };
+		for (auto e : reg.view<TestComponentOne>()) count++;
+		for (auto e : reg.view<Relationship>())
+		{
+			if (!isNullEntity(reg.get<Relationship>(e).parent)) children++;
+		}
+		ASSERT_EQ(true, count == 1001);
+		ASSERT_EQ(true, children == 9);
+		ASSERT_EQ(true, reg.get<TestComponentOne>(existing).id == -1);
+		count = 0;
+		for (auto e : reg.view<TestComponentOne, TestComponentTwo>())
+		{
+			ASSERT_EQ(true, reg.get<TestComponentOne>(e).id == reg.get<TestComponentTwo>(e).id);
+			count++;
+		}
+		ASSERT_EQ(true, count == 499);
+	}
+
+	TEST(RegistryTesting, RegistryTestingAccessChecker)
+	{
+		std::vector<std::string> reports;
+		tent::AccessChecker::setHandler([&](const std::string& report) { reports.push_back(report); });
+		tent::AccessChecker checker;
+
+		//reads from several threads and accesses from the same thread never conflict.
+		checker.begin(false, "View");
+		std::thread reader([&]()
+			{
+				tent::AccessLabel label("render");
+				checker.begin(false, "View");
+				checker.end(false);
+			});
+		reader.join();
+		checker.begin(true, "Registry::get");
+		checker.end(true);
+		ASSERT_EQ(true, reports.empty());
+
+		//a write from another thread names both sides.
+		std::thread writer([&]()
+			{
+				tent::AccessLabel label("physics");
+				checker.begin(true, "Pool::emplace_back");
+				checker.end(true);
+			});
+		writer.join();
+		checker.end(false);
+		ASSERT_EQ(true, reports.size() == 1);
+		ASSERT_EQ(true, reports[0].find("write in Pool::emplace_back (physics)") != std::string::npos);
+		ASSERT_EQ(true, reports[0].find("read in View") != std::string::npos);
+
+#ifdef TENT_ACCESS_CHECKS
+		//a view writes its non const Components for as long as it lives.
+		reports.clear();
+		TestRegistry reg;
+		tent::Entity e = reg.createEntity();
+		reg.emplace_back<TestComponentOne>(e, 1);
+		{
+			auto reading = reg.view<const TestComponentOne>();
+			std::thread other([&]() { auto alsoReading = reg.view<const TestComponentOne>(); });
+			other.join();
+			ASSERT_EQ(true, reports.empty());
+			std::thread writer([&]() { auto writing = reg.view<TestComponentOne>(); });
+			writer.join();
+			ASSERT_EQ(true, reports.size() == 1);
+		}
+		{
+			auto writing = reg.view<TestComponentOne>();
+			for (auto e : writing) writing.get<TestComponentOne>(e).id++;
+			std::thread reader([&]() { auto reading = reg.view<const TestComponentOne>(); });
+			reader.join();
+			ASSERT_EQ(true, reports.size() == 2);
+		}
+#endif
+		tent::AccessChecker::setHandler([](const std::string& report) { FAIL() << report; });
+	}
+
+	TEST(RegistryTesting, RegistryTestingMappedStorage)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		//grows the mapping several times.
+		for (int i = 0; i < 10000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestMappedComponent>(e, TestMappedComponent{ i, i * 0.5f });
+			if (i % 2 == 0) reg.emplace_back<TestComponentOne>(e, i);
+			entities.push_back(e);
+		}
+		for (int i = 0; i < 10000; i += 3)
+		{
+			reg.remove<TestMappedComponent>(entities[i]);
+		}
+		ASSERT_EQ(true, reg.exists<TestMappedComponent>(entities[0]) == false);
+		ASSERT_EQ(true, reg.get<TestMappedComponent>(entities[1]).id == 1);
+
+		int count{ 0 };
+		auto view = reg.view<TestMappedComponent, TestComponentOne>();
+		for (auto e : view)
+		{
+			auto& c = view.get<TestMappedComponent>(e);
+			ASSERT_EQ(true, c.id == view.get<TestComponentOne>(e).id);
+			ASSERT_EQ(true, c.value == c.id * 0.5f);
+			count++;
+		}
+		//even and not a multiple of 3.
+		ASSERT_EQ(true, count == 3333);
+
+		tent::MappedVector<int> ints;
+		for (int i = 0; i < 5000; i++) ints.push_back(i);
+		ints.shrink_to_fit();
+		ASSERT_EQ(true, ints.capacity() == 5000 && ints[4999] == 4999);
+		tent::MappedVector<int> moved(std::move(ints));
+		ASSERT_EQ(true, ints.empty() && moved.size() == 5000 && moved.back() == 4999);
+	}
+
+	TEST(RegistryTesting, RegistryTestingAlignedStorage)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 1000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestSimdComponent>(e);
+			reg.emplace_back<TestPaddedComponent>(e, i);
+			entities.push_back(e);
+		}
+		//every over aligned component is aligned, the padded pool starts on a cache line.
+		for (auto& e : entities)
+		{
+			ASSERT_EQ(true, reinterpret_cast<std::uintptr_t>(&reg.get<TestSimdComponent>(e)) % 32 == 0);
+		}
+		ASSERT_EQ(true, reinterpret_cast<std::uintptr_t>(&reg.get<TestPaddedComponent>(entities[0])) % 64 == 0);
+		ASSERT_EQ(true, reg.get<TestPaddedComponent>(entities[999]).id == 999);
+
+		using PaddedPool = tent::ComponentStorage<tent::Entity, TestPaddedComponent>;
+		ASSERT_EQ(true, PaddedPool::ALIGNMENT == 64);
+		ASSERT_EQ(true, (tent::ComponentStorage<tent::Entity, TestSimdComponent>::ALIGNMENT == 32));
+		//16 ints fill a cache line.
+		ASSERT_EQ(true, PaddedPool::alignedChunkSize(100) == 112);
+		ASSERT_EQ(true, PaddedPool::alignedChunkSize(0) == 16);
+	}
+
+	TEST(RegistryTesting, RegistryTestingStaticRegistry)
+	{
+		using StaticTestRegistry = tent::StaticRegistry<TestComponentOne, TestComponentTwo, TestComponentThree>;
+		static_assert(StaticTestRegistry::index<TestComponentTwo>() == 1);
+		StaticTestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 1000; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestComponentOne>(e, i);
+			if (i % 2 == 0) reg.push<TestComponentTwo>(e, TestComponentTwo(i));
+			if (i % 3 == 0) reg.emplace_back<TestComponentThree>(e, i);
+			entities.push_back(e);
+		}
+		ASSERT_EQ(true, reg.get<TestComponentOne>(entities[10]).id == 10);
+		ASSERT_EQ(true, reg.try_get<TestComponentTwo>(entities[1]) == nullptr);
+		auto [one, two] = reg.get<TestComponentOne, TestComponentTwo>(entities[4]);
+		ASSERT_EQ(true, one.id == 4 && two.id == 4);
+
+		int count{ 0 };
+		for (auto e : reg.view<TestComponentOne, TestComponentTwo>(exclude<TestComponentThree>))
+		{
+			ASSERT_EQ(true, reg.get<TestComponentOne>(e).id % 2 == 0 && reg.get<TestComponentOne>(e).id % 3 != 0);
+			count++;
+		}
+		ASSERT_EQ(true, count == 333);
+		count = 0;
+		reg.view<TestComponentTwo, TestComponentThree>().each([&](tent::Entity& e, TestComponentTwo& t, TestComponentThree& th)
+			{
+				ASSERT_EQ(true, t.id == th.id && t.id % 6 == 0);
+				count++;
+			});
+		ASSERT_EQ(true, count == 167);
+
+		//kill removes e from every pool and recycles it.
+		reg.kill(entities[0]);
+		ASSERT_EQ(true, reg.exists(entities[0]) == false);
+		ASSERT_EQ(true, reg.exists<TestComponentTwo>(entities[0]) == false);
+		reg.remove<TestComponentOne, TestComponentThree>(entities[3]);
+		ASSERT_EQ(true, reg.exists(entities[3]) && !reg.exists<TestComponentOne>(entities[3]));
+		tent::Entity recycled = reg.createEntity();
+		ASSERT_EQ(true, getEntityIndex(recycled) == getEntityIndex(entities[0]));
+		//a recycled entity does not use up an id.
+		tent::Entity probe;
+		reg.kill(entities[1]);
+		reg.createEntity();
+		tent::Entity fresh = reg.createEntity();
+		ASSERT_EQ(true, getEntityIndex(fresh) == getEntityIndex(probe) + 1);
+
+		reg.clear();
+		ASSERT_EQ(true, reg.exists(entities[2]) == false);
+		ASSERT_EQ(true, reg.memoryStats().entities == 0 && reg.memoryStats().recycleableEntities == 1001);
+	}
+
+	TEST(RegistryTesting, RegistryTestingIndex)
+	{
+		TestRegistry reg;
+		std::vector<tent::Entity> entities;
+		for (int i = 0; i < 100; i++)
+		{
+			tent::Entity e = reg.createEntity();
+			reg.emplace_back<TestCopyableComponent>(e, i);
+			entities.push_back(e);
+		}
+		//created after the pool was filled so it indexes what is already there.
+		auto& byId = reg.addIndex<TestCopyableComponent>([](const TestCopyableComponent& c) { return c.id; });
+		auto& byBucket = reg.addOrderedIndex<TestCopyableComponent>([](const TestCopyableComponent& c) { return c.id / 10; });
+		ASSERT_EQ(true, byId.size() == 100 && byId.find(42) == entities[42]);
+		ASSERT_EQ(true, byBucket.count(3) == 10);
+
+		tent::Entity e = reg.createEntity();
+		reg.push<TestCopyableComponent>(e, TestCopyableComponent(500));
+		ASSERT_EQ(true, byId.find(500) == e);
+
+		//patch moves the entity to its new key.
+		reg.patch<TestCopyableComponent>(entities[5], [](TestCopyableComponent& c) { c.id = 1000; });
+		ASSERT_EQ(true, isNullEntity(byId.find(5)) && byId.find(1000) == entities[5]);
+		reg.get<TestCopyableComponent>(entities[6]).id = 2000;
+		reg.patch<TestCopyableComponent>(entities[6]);
+		ASSERT_EQ(true, byId.find(2000) == entities[6]);
+
+		reg.remove<TestCopyableComponent>(entities[7]);
+		reg.kill(entities[8]);
+		ASSERT_EQ(true, byId.count(7) == 0 && byId.count(8) == 0);
+		int count{ 0 };
+		byBucket.range(0, 1, [&](tent::Entity& found)
+			{
+				ASSERT_EQ(true, reg.get<TestCopyableComponent>(found).id < 20);
+				count++;
+			});
+		//ids 5 to 8 left the first bucket.
+		ASSERT_EQ(true, count == 16);
+
+		std::vector<tent::Entity> copies;
+		reg.clone(entities[9], 3, std::back_inserter(copies));
+		ASSERT_EQ(true, byId.count(9) == 4);
+
+		reg.clear<TestCopyableComponent>();
+		ASSERT_EQ(true, byId.size() == 0 && byBucket.size() == 0);
+	}
+
 	TEST(RegistryTesting, RegistryTestingLoadTest)
 	{
 		std::size_t n_entities{ 100000 };
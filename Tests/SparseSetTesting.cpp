@@ -115,4 +115,36 @@ namespace SparseSetTesting_Class
 		ASSERT_EQ(true, setOne.exists(eFour) == false);
 
 	}
+
+	TEST(SparseSetTesting, SparseSetTestingGeneration)
+	{
+		tent::Entity eOne{ 3u };
+		tent::Entity eTwo{ 7u };
+		tent::Entity eThree{ 9u };
+		//same index as eOne but the next generation.
+		tent::Entity stale{ 3u | (1u << tent::MAX_INDEX_BITS) };
+
+		tent::SparseSet<tent::Entity> setOne;
+		setOne.push(eOne);
+		setOne.push(eTwo);
+		setOne.push(eThree);
+		ASSERT_EQ(true, setOne.exists(eOne));
+		ASSERT_EQ(true, setOne.exists(stale) == false);
+		ASSERT_EQ(true, setOne.find(stale) == tent::ENTITY_NULL_ID);
+
+		//removing moves the last entity into the hole and keeps its generation.
+		setOne.remove(eOne);
+		ASSERT_EQ(true, setOne.find(eThree) == 0);
+		ASSERT_EQ(true, setOne.get(eThree) == eThree);
+		ASSERT_EQ(true, setOne.index(eTwo) == 1);
+		ASSERT_EQ(true, setOne.push(stale));
+		ASSERT_EQ(true, setOne.exists(stale));
+		ASSERT_EQ(true, setOne.exists(eOne) == false);
+		ASSERT_EQ(false, setOne.push(stale));
+#ifdef NDEBUG
+		//the index is still held by stale so the older generation is rejected.
+		ASSERT_EQ(false, setOne.push(eOne));
+		ASSERT_EQ(true, setOne.exists(eOne) == false && setOne.size() == 3);
+#endif
+	}
 }
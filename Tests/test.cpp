@@ -1,5 +1,8 @@
 #include <iostream>
 #include "gtest/gtest.h"
+#include "../src/Simulation.h"
+
+TENT_DEFINE_ALLOCATION_HOOKS()
 
 int main(int argc, char** argv)
 {
@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Concurrent access checks are compiled out unless TENT_ACCESS_CHECKS is defined project
+* wide (it changes the layout of the pools and View so every translation unit has to agree
+* on it). When it is disabled the macros below expand to nothing.
+*/
+#ifdef TENT_ACCESS_CHECKS
+#define TENT_ACCESS_CONCAT_IMPL(a, b) a##b
+#define TENT_ACCESS_CONCAT(a, b) TENT_ACCESS_CONCAT_IMPL(a, b)
+#define TENT_ACCESS_READ(checker, operation) ::tent::AccessScope TENT_ACCESS_CONCAT(tentAccessScope, __LINE__)(checker, false, operation)
+#define TENT_ACCESS_WRITE(checker, operation) ::tent::AccessScope TENT_ACCESS_CONCAT(tentAccessScope, __LINE__)(checker, true, operation)
+#define TENT_ACCESS_LABEL(label) ::tent::AccessLabel TENT_ACCESS_CONCAT(tentAccessLabel, __LINE__)(label)
+#else
+#define TENT_ACCESS_READ(checker, operation)
+#define TENT_ACCESS_WRITE(checker, operation)
+#define TENT_ACCESS_LABEL(label)
+#endif
+
+namespace tent
+{
+	/*
+	* @brief Keeps track of which threads are reading or writing a single pool and reports
+	* a write that overlaps with any access from another thread, or a read that overlaps
+	* with a write from another thread. Every pool owns one when TENT_ACCESS_CHECKS is defined.
+	* A report names the operation, label and thread of both accesses and aborts unless a
+	* different handler was set.
+	*/
+	class AccessChecker
+	{
+	public:
+		using handler_type = std::function<void(const std::string&)>;
+
+	private:
+		struct Access
+		{
+			std::thread::id thread;
+			bool write;
+			const char* operation;
+			const char* label;
+		};
+
+		std::mutex lock;
+		std::vector<Access> active;
+
+		static handler_type& handler()
+		{
+			static handler_type h = [](const std::string& report)
+			{
+				std::cerr << report << std::endl;
+				std::abort();
+			};
+			return h;
+		}
+
+		static std::string describe(const Access& a)
+		{
+			std::ostringstream out;
+			out << (a.write ? "write" : "read") << " in " << a.operation;
+			if (a.label != nullptr) out << " (" << a.label << ")";
+			out << " on thread " << a.thread;
+			return out.str();
+		}
+
+	public:
+		AccessChecker() {}
+		AccessChecker(const AccessChecker&) = delete;
+		AccessChecker& operator=(const AccessChecker&) = delete;
+
+		/*
+		* @brief Label of the system running on this thread, included in reports.
+		*/
+		static const char*& currentLabel()
+		{
+			thread_local const char* label{ nullptr };
+			return label;
+		}
+
+		/*
+		* @brief Replaces what happens when a conflict is found. Used by tests to
+		* catch the report instead of aborting.
+		*/
+		static void setHandler(handler_type h)
+		{
+			handler() = std::move(h);
+		}
+
+		/*
+		* @brief Registers an access that lasts until the matching end call.
+		* @param write is true when the pool may be changed.
+		* @param operation has to outlive the access, string literals are expected.
+		*/
+		void begin(bool write, const char* operation)
+		{
+			Access access{ std::this_thread::get_id(), write, operation, currentLabel() };
+			std::string report;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				for (const Access& other : active)
+				{
+					if (other.thread == access.thread || !(write || other.write)) continue;
+					report = "Tent: conflicting pool access, " + describe(access) + " while " + describe(other);
+					break;
+				}
+				active.push_back(access);
+			}
+			if (!report.empty()) handler()(report);
+		}
+
+		void end(bool write)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			std::thread::id thread = std::this_thread::get_id();
+			for (std::size_t i = active.size(); i-- > 0;)
+			{
+				if (active[i].thread == thread && active[i].write == write)
+				{
+					active.erase(active.begin() + i);
+					return;
+				}
+			}
+		}
+	};
+
+	/*
+	* @brief Holds an access to a pool for the scope it lives in.
+	* Use TENT_ACCESS_READ and TENT_ACCESS_WRITE instead of creating one directly.
+	*/
+	class AccessScope
+	{
+	private:
+		AccessChecker* checker;
+		bool write;
+
+	public:
+		AccessScope(AccessChecker& _checker, bool _write, const char* operation) : checker(&_checker), write(_write)
+		{
+			checker->begin(write, operation);
+		}
+		AccessScope(AccessScope&& o) noexcept : checker(o.checker), write(o.write) { o.checker = nullptr; }
+		AccessScope(const AccessScope&) = delete;
+		AccessScope& operator=(const AccessScope&) = delete;
+		~AccessScope()
+		{
+			if (checker != nullptr) checker->end(write);
+		}
+	};
+
+	/*
+	* @brief Labels every access made on this thread for the scope it lives in,
+	* typically with the name of the system that is running.
+	*/
+	class AccessLabel
+	{
+	private:
+		const char* previous;
+
+	public:
+		AccessLabel(const char* label) : previous(AccessChecker::currentLabel())
+		{
+			AccessChecker::currentLabel() = label;
+		}
+		AccessLabel(const AccessLabel&) = delete;
+		AccessLabel& operator=(const AccessLabel&) = delete;
+		~AccessLabel()
+		{
+			AccessChecker::currentLabel() = previous;
+		}
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace tent
+{
+	//size of a cache line on the platforms Tent targets.
+	constexpr std::size_t CACHE_LINE_SIZE{ 64 };
+
+	/*
+	* @brief Allocator that places every allocation on an Alignment boundary, so the first
+	* element of a pool can be loaded with aligned SIMD instructions or starts on its own
+	* cache line.
+	* @tparam Alignment has to be a power of two and at least alignof(T).
+	*/
+	template<typename T, std::size_t Alignment = alignof(T)>
+	class AlignedAllocator
+	{
+		static_assert(Alignment >= alignof(T), "Alignment can not be smaller than alignof the Component.");
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment has to be a power of two.");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using is_always_equal = std::true_type;
+
+		static constexpr size_type alignment{ Alignment };
+
+		template<typename U>
+		struct rebind
+		{
+			using other = AlignedAllocator<U, (Alignment > alignof(U) ? Alignment : alignof(U))>;
+		};
+
+		AlignedAllocator() noexcept {}
+		template<typename U, std::size_t A>
+		AlignedAllocator(const AlignedAllocator<U, A>&) noexcept {}
+
+		T* allocate(size_type n)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+		}
+
+		void deallocate(T* p, size_type) noexcept
+		{
+			::operator delete(p, std::align_val_t(Alignment));
+		}
+	};
+
+	template<typename T, std::size_t A, typename U, std::size_t B>
+	bool operator == (const AlignedAllocator<T, A>&, const AlignedAllocator<U, B>&) noexcept
+	{
+		return A == B;
+	}
+
+	template<typename T, std::size_t A, typename U, std::size_t B>
+	bool operator != (const AlignedAllocator<T, A>&, const AlignedAllocator<U, B>&) noexcept
+	{
+		return A != B;
+	}
+}
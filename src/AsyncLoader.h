@@ -0,0 +1,109 @@
+#pragma once
+#include <chrono>
+#include <future>
+#include <memory>
+#include <utility>
+#include <Logi/Logi.h>
+
+#include "Registry.h"
+#include "Profiler.h"
+
+namespace tent
+{
+	/*
+	* @brief Decodes a Registry fragment on a worker thread into a staging Registry and
+	* merges it into a live Registry in time budgeted slices, so loading a zone never
+	* blocks a frame for long.
+	* Syntax:
+	* loader.load([bytes](Registry& staging) { ... decode bytes into staging ... });
+	* every frame: if (loader.integrate(reg, std::chrono::microseconds(500))) { zone is in }
+	* @NOTE decode runs on another thread. It may only touch the staging Registry it is given.
+	*/
+	template<typename E>
+	class AsyncLoader
+	{
+	public:
+		using registry_type = BasicRegistry<E>;
+
+	private:
+		std::future<std::unique_ptr<registry_type>> pending;
+		std::unique_ptr<registry_type> staging;
+		std::size_t sliceSize;
+
+	public:
+		/*
+		* @param _sliceSize is the number of entities merged between checks of the time budget.
+		*/
+		AsyncLoader(std::size_t _sliceSize = 256) : sliceSize(_sliceSize) {}
+
+		~AsyncLoader()
+		{
+			//the worker must not outlive the loader.
+			if (pending.valid()) pending.wait();
+		}
+
+		/*
+		* @brief Starts decoding a fragment on a worker thread.
+		* @param decode is called as decode(registry_type& staging) on the worker thread.
+		* @return false without starting when the previous fragment has not been integrated yet.
+		*/
+		template<typename Decode>
+		bool load(Decode&& decode)
+		{
+			ASSERT_ERROR(!busy(), "The previous fragment has not been integrated yet.");
+			if (busy()) return false;
+			pending = std::async(std::launch::async, [decode = std::forward<Decode>(decode)]() mutable
+				{
+					TENT_PROFILE_SCOPE("AsyncLoader::decode", nullptr);
+					auto out = std::make_unique<registry_type>();
+					decode(*out);
+					return out;
+				});
+			return true;
+		}
+
+		/*
+		* @brief Returns true while a fragment is being decoded or waiting to be integrated.
+		*/
+		bool busy() const
+		{
+			return pending.valid() || staging != nullptr;
+		}
+
+		/*
+		* @brief Returns true once the worker has finished decoding. Does not block.
+		*/
+		bool decoded() const
+		{
+			return staging != nullptr || (pending.valid() && pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+		}
+
+		/*
+		* @brief Merges the decoded fragment into reg until budget runs out. Does nothing while
+		* the worker is still decoding. Exceptions thrown by decode are rethrown here.
+		* @param reg is the Registry the fragment is merged into.
+		* @param budget is roughly how long this call may take.
+		* @return true once the whole fragment is part of reg.
+		*/
+		template<typename Rep, typename Period>
+		bool integrate(registry_type& reg, std::chrono::duration<Rep, Period> budget)
+		{
+			TENT_PROFILE_SCOPE("AsyncLoader::integrate", this);
+			if (staging == nullptr)
+			{
+				if (!decoded()) return false;
+				staging = pending.get();
+			}
+			auto end = std::chrono::steady_clock::now() + budget;
+			do
+			{
+				if (reg.mergeIncremental(*staging, sliceSize))
+				{
+					staging.reset();
+					return true;
+				}
+			} while (std::chrono::steady_clock::now() < end);
+			return false;
+		}
+	};
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <type_traits>
+#include <utility>
+
+#include "ComponentStorage.h"
+
+namespace tent
+{
+	/*
+	* @brief Type erased base so the Registry can keep the indexes of every Component
+	* up to date without knowing the Component or key type.
+	*/
+	template<typename E>
+	class IndexBase
+	{
+	public:
+		virtual ~IndexBase() {}
+		//indexes e's Component or updates its entry, does nothing when e does not own one.
+		virtual void insert(E& e) = 0;
+		virtual void erase(const E& e) = 0;
+		virtual void clear() = 0;
+		virtual void rebuild() = 0;
+	};
+
+	/*
+	* @brief Maps a key taken from every Component of a pool to the entities owning it, so
+	* entities can be looked up by Component value instead of scanning the pool.
+	* Created and kept up to date by Registry::addIndex and Registry::addOrderedIndex.
+	* @NOTE A Component changed through get or a View has to be passed to Registry::patch
+	* for its key to be updated.
+	* @tparam Map is a multimap from Key to E, hashed (HashIndex) or sorted (OrderedIndex).
+	*/
+	template<typename E, typename Component, typename Key, typename Map>
+	class ComponentIndex : public IndexBase<E>
+	{
+	public:
+		using entity_type = E;
+		using key_type = Key;
+		using extractor_type = std::function<key_type(const Component&)>;
+		using size_type = std::size_t;
+
+	private:
+		ComponentStorage<E, Component>* pool;
+		extractor_type extract;
+		Map entities;
+		//the key each entity is indexed under, so it can be found after the Component changed.
+		std::unordered_map<entity_type, key_type> keys;
+
+		void eraseEntry(const key_type& key, const entity_type& e)
+		{
+			auto range = entities.equal_range(key);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == e)
+				{
+					entities.erase(it);
+					return;
+				}
+			}
+		}
+
+	public:
+		ComponentIndex(ComponentStorage<E, Component>* _pool, extractor_type _extract) : pool(_pool), extract(std::move(_extract))
+		{
+			rebuild();
+		}
+
+		void insert(entity_type& e) override
+		{
+			if (!pool->exists(e)) return;
+			key_type key = extract(pool->read(e));
+			auto found = keys.find(e);
+			if (found != keys.end())
+			{
+				if (found->second == key) return;
+				eraseEntry(found->second, e);
+				found->second = key;
+			}
+			else
+			{
+				keys.emplace(e, key);
+			}
+			entities.emplace(std::move(key), e);
+		}
+
+		void erase(const entity_type& e) override
+		{
+			auto found = keys.find(e);
+			if (found == keys.end()) return;
+			eraseEntry(found->second, e);
+			keys.erase(found);
+		}
+
+		void clear() override
+		{
+			entities.clear();
+			keys.clear();
+		}
+
+		/*
+		* @brief Indexes every Component of the pool again.
+		*/
+		void rebuild() override
+		{
+			clear();
+			keys.reserve(pool->size());
+			entity_type* indexed = pool->entityData();
+			for (size_type i = 0; i < pool->size(); i++)
+			{
+				insert(indexed[i]);
+			}
+		}
+
+		/*
+		* @brief Returns an entity whose Component has key or a null entity if there is none.
+		*/
+		entity_type find(const key_type& key) const
+		{
+			auto it = entities.find(key);
+			return it == entities.end() ? entity_type(entity_type::null_id) : it->second;
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return entities.count(key);
+		}
+
+		/*
+		* @brief Calls func(entity_type&) for every entity whose Component has key.
+		*/
+		template<typename Func>
+		void each(const key_type& key, Func&& func) const
+		{
+			auto range = entities.equal_range(key);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				entity_type e = it->second;
+				func(e);
+			}
+		}
+
+		/*
+		* @brief Calls func(entity_type&) for every entity whose key is in [first, last],
+		* in key order. Only available on an OrderedIndex.
+		*/
+		template<typename Func>
+		void range(const key_type& first, const key_type& last, Func&& func) const
+		{
+			for (auto it = entities.lower_bound(first), end = entities.upper_bound(last); it != end; ++it)
+			{
+				entity_type e = it->second;
+				func(e);
+			}
+		}
+
+		/*
+		* @brief Returns the number of indexed entities.
+		*/
+		size_type size() const
+		{
+			return keys.size();
+		}
+	};
+
+	//the key type extract returns for a Component.
+	template<typename Component, typename Extractor>
+	using index_key_t = std::decay_t<std::invoke_result_t<Extractor&, const Component&>>;
+
+	template<typename E, typename Component, typename Key>
+	using HashIndex = ComponentIndex<E, Component, Key, std::unordered_multimap<Key, E>>;
+
+	template<typename E, typename Component, typename Key>
+	using OrderedIndex = ComponentIndex<E, Component, Key, std::multimap<Key, E>>;
+}
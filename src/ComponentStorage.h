@@ -1,16 +1,56 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
 #include <Logi/Logi.h>
 
 #include "SparseSet.h"
+#include "AlignedAllocator.h"
 
 namespace tent
 {
+	/*
+	* @brief Picks the container a Component's pool stores its components in. Specialize it
+	* to move a Component out of the heap, for example into a MappedVector:
+	* namespace tent { template<> struct storage_traits<Position> { using container_type = MappedVector<Position>; }; }
+	* @NOTE The specialization has to be visible wherever the Component's pool is used.
+	*/
+	template<typename Component>
+	struct storage_traits
+	{
+		using container_type = std::vector<Component>;
+	};
+
+	/*
+	* @brief Stores a Component's pool on Alignment boundaries, for example to make aligned
+	* SIMD loads possible or to keep a pool off the cache line of other data:
+	* namespace tent { template<> struct storage_traits<Particles> : aligned_storage_traits<Particles, 64> {}; }
+	* Over aligned Components (alignas) already get their alignment from the default storage.
+	*/
+	template<typename Component, std::size_t Alignment>
+	struct aligned_storage_traits
+	{
+		using container_type = std::vector<Component, AlignedAllocator<Component, Alignment>>;
+	};
+
+	/*
+	* @brief The alignment the first element of a Container is guaranteed to have.
+	*/
+	template<typename Container, typename = void>
+	struct container_alignment : std::integral_constant<std::size_t, alignof(typename Container::value_type)> {};
+
+	template<typename Container>
+	struct container_alignment<Container, std::void_t<decltype(Container::allocator_type::alignment)>>
+		: std::integral_constant<std::size_t, Container::allocator_type::alignment> {};
+
 	/*
 	* @brief Wraps SparseSet to provide type erasure for different Component types.
 	*/
-	template<typename E, typename Component, typename Container = std::vector<Component>>
+	template<typename E, typename Component, typename Container = typename storage_traits<Component>::container_type>
 	class ComponentStorage : public SparseSet<E>
 	{
 	public:
@@ -20,9 +60,59 @@ namespace tent
 		using baseStorageType = SparseSet<E>; //gives access to underlying instance of SparseSet<E> and its methods
 		using size_type = std::size_t;
 
+		//number of components per page when pages are tracked.
+		static constexpr size_type PAGE_SIZE{ 1024 };
+		//alignment of the first component in the pool.
+		static constexpr size_type ALIGNMENT{ container_alignment<Container>::value };
+
+		/*
+		* @brief Rounds minimum up so that splitting the pool into chunks of the returned size
+		* starts every chunk on a new cache line. Threads that each write to their own chunk
+		* then never share a cache line (false sharing) when the pool is cache line aligned.
+		* @param minimum is the smallest number of components a chunk should hold.
+		* @return The chunk size in components.
+		*/
+		static constexpr size_type alignedChunkSize(size_type minimum)
+		{
+			size_type a = sizeof(value_type);
+			size_type b = CACHE_LINE_SIZE;
+			while (b != 0)
+			{
+				size_type t = a % b;
+				a = b;
+				b = t;
+			}
+			//number of components that make up a whole number of cache lines.
+			size_type step = CACHE_LINE_SIZE / a;
+			return minimum == 0 ? step : (minimum + step - 1) / step * step;
+		}
+
 	private:
 		//densely packed vector of instances of type Component
 		container_type components;
+		//when tracking, dirtyPages[i] is set once a component in page i may have changed.
+		bool trackingPages{ false };
+		std::vector<uint8_t> dirtyPages;
+
+		/*
+		* @brief Marks the page holding the component at index i as changed.
+		*/
+		void markPage(size_type i)
+		{
+			if (!trackingPages) return;
+			size_type page = i / PAGE_SIZE;
+			if (page >= dirtyPages.size())
+			{
+				dirtyPages.resize(page + 1u, 1);
+			}
+			dirtyPages[page] = 1;
+		}
+
+		void markAllPages()
+		{
+			if (!trackingPages) return;
+			dirtyPages.assign((components.size() + PAGE_SIZE - 1) / PAGE_SIZE, 1);
+		}
 
 
 	public:
@@ -38,13 +128,15 @@ namespace tent
 		*/
 		void push(entity_type& e, value_type&& c)
 		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::push");
 			if (baseStorageType::exists(e))
 			{
 				LOG_WARNING("Trying to add a duplicate component to entity.");
 				return;
 			}
-			baseStorageType::push(e);
+			if (!baseStorageType::push(e)) return;
 			components.push_back(std::move(c));
+			markPage(components.size() - 1);
 		}
 
 		/*
@@ -60,13 +152,15 @@ namespace tent
 		template<typename ...Args>
 		void emplace_back(entity_type& e, Args&& ... args)
 		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::emplace_back");
 			if (baseStorageType::exists(e))
 			{
 				LOG_WARNING("Trying to add a duplicate component to entity.");
 				return;
 			}
-			baseStorageType::push(e);
+			if (!baseStorageType::push(e)) return;
 			components.emplace_back(args...);
+			markPage(components.size() - 1);
 		}
 
 		/*
@@ -86,6 +180,119 @@ namespace tent
 			}	
 		}
 
+		std::unique_ptr<baseStorageType> createEmpty() const override
+		{
+			return std::make_unique<ComponentStorage<E, Component, Container>>();
+		}
+
+		/*
+		* @brief Appends every entity of other and their components to the end of this pool.
+		* The components are moved in one bulk insert.
+		* @NOTE None of other's entities can already be in this pool. other is left
+		* in a moved from state and has to be discarded afterwards.
+		* @param other is a pool of the same Component type as this one.
+		*/
+		void append(baseStorageType& other) override
+		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::append");
+			auto& o = static_cast<ComponentStorage<E, Component, Container>&>(other);
+			components.reserve(components.size() + o.components.size());
+			size_type first = components.size();
+			components.insert(components.end(), std::make_move_iterator(o.components.begin()), std::make_move_iterator(o.components.end()));
+			baseStorageType::append(other);
+			for (size_type i = first; i < components.size(); i += PAGE_SIZE) markPage(i);
+			if (first < components.size()) markPage(components.size() - 1);
+		}
+
+		/*
+		* @brief Appends count copies of source's component to dst in one bulk insert.
+		* dst can be this pool.
+		* @NOTE Component has to be copy constructible. None of targets can already be in dst.
+		* @param dst is a pool of the same Component type as this one.
+		* @param source is an entity in this pool.
+		* @param targets points at count entities that will own the copies.
+		* @param count is the number of copies.
+		*/
+		void cloneTo(baseStorageType& dst, entity_type& source, const entity_type* targets, size_type count) override
+		{
+			if constexpr (std::is_copy_constructible_v<value_type>)
+			{
+				ASSERT_ERROR(baseStorageType::exists(source), "Entity does not exist.");
+				auto& o = static_cast<ComponentStorage<E, Component, Container>&>(dst);
+				TENT_ACCESS_WRITE(o.access(), "Pool::cloneTo");
+				//copied first since growing o can move the component when o is this pool.
+				value_type prototype(components[baseStorageType::index_unchecked(source)]);
+				size_type first = o.components.size();
+				//for trivially copyable Components this is a single fill of the new range.
+				o.components.insert(o.components.end(), count, prototype);
+				o.appendEntities(targets, count);
+				for (size_type i = first; i < o.components.size(); i += PAGE_SIZE) o.markPage(i);
+				if (first < o.components.size()) o.markPage(o.components.size() - 1);
+			}
+			else
+			{
+				//Registry::clone checks copyable before it creates any entity.
+				ASSERT_FATAL(false, "Only copy constructible Components can be cloned.");
+				(void)dst; (void)source; (void)targets; (void)count;
+			}
+		}
+
+		bool copyable() const override
+		{
+			return std::is_copy_constructible_v<value_type>;
+		}
+
+		/*
+		* @brief Moves e and its component from this pool into dst.
+		* @param dst is a pool of the same Component type as this one.
+		* @param e is a reference to an instance of Entity.
+		*/
+		void moveTo(baseStorageType& dst, entity_type& e) override
+		{
+			if (!baseStorageType::exists(e)) return;
+			entity_type temp{ e };
+			static_cast<ComponentStorage<E, Component, Container>&>(dst).push(temp, std::move(get(temp)));
+			remove(temp);
+		}
+
+		/*
+		* @brief Moves the entities and components from position first to the end into dst
+		* with one bulk insert per array.
+		* @param dst is a pool of the same Component type as this one.
+		* @param first is the position of the first component to move.
+		*/
+		void moveTailTo(baseStorageType& dst, size_type first) override
+		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::moveTailTo");
+			auto& o = static_cast<ComponentStorage<E, Component, Container>&>(dst);
+			TENT_ACCESS_WRITE(o.access(), "Pool::moveTailTo");
+			size_type start = o.components.size();
+			o.components.insert(o.components.end(), std::make_move_iterator(components.begin() + first), std::make_move_iterator(components.end()));
+			for (size_type i = start; i < o.components.size(); i += PAGE_SIZE) o.markPage(i);
+			if (start < o.components.size()) o.markPage(o.components.size() - 1);
+			if (first < components.size()) markPage(first);
+			while (components.size() > first) components.pop_back();
+			baseStorageType::moveTailTo(dst, first);
+		}
+
+		/*
+		* @brief Rearranges the components and entities so the ones at order[i] are moved to i.
+		* @param order is a permutation of the indices of the components vector.
+		*/
+		void arrange(const std::vector<size_type>& order) override
+		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::arrange");
+			container_type arranged;
+			arranged.reserve(components.size());
+			for (size_type i : order)
+			{
+				arranged.push_back(std::move(components[i]));
+			}
+			components.swap(arranged);
+			baseStorageType::arrange(order);
+			markAllPages();
+		}
+
 		/*
 		* @brief Takes e's component, swaps it to the end of the components vector 
 		* and then removes it. This method is called by baseStorageType::remove(Entity& e).
@@ -96,16 +303,121 @@ namespace tent
 		*/
 		void remove(entity_type& e) override
 		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::remove");
 			if (!baseStorageType::exists(e)) return;
+			markPage(baseStorageType::index(e));
+			markPage(components.size() - 1);
 			swap(e, baseStorageType::last(), false);
 			components.pop_back();
 			baseStorageType::remove(e);
 		}
 
+		void* rawGet(entity_type& e) override
+		{
+			return try_get(e);
+		}
+
+		size_type componentSize() const override
+		{
+			return sizeof(value_type);
+		}
+
+		size_type componentAlignment() const override
+		{
+			return alignof(value_type);
+		}
+
+		/*
+		* @brief Destroys every component and removes every entity but keeps the allocations.
+		*/
+		void clear() override
+		{
+			TENT_ACCESS_WRITE(baseStorageType::access(), "Pool::clear");
+			components.clear();
+			baseStorageType::clear();
+			dirtyPages.assign(dirtyPages.size(), 1);
+		}
+
+		void compact() override
+		{
+			components.shrink_to_fit();
+			baseStorageType::compact();
+		}
+
+		void memoryStats(PoolMemoryStats& out) const override
+		{
+			baseStorageType::memoryStats(out);
+			out.componentBytes = components.size() * sizeof(value_type);
+			out.componentCapacityBytes = components.capacity() * sizeof(value_type);
+		}
+
 		value_type& get(entity_type& e)
 		{
 			//call to baseStorageType::index(e) will assert that e exists.
-			return components[baseStorageType::index(e)];	
+			size_type i = baseStorageType::index(e);
+			markPage(i);
+			baseStorageType::touch(i);
+			return components[i];
+		}
+
+		/*
+		* @brief Returns a pointer to e's component or nullptr if e does not
+		* own one. Only probes the sparse vector once.
+		* @param e is a reference to an instance of Entity.
+		* @return A pointer to e's component or nullptr.
+		*/
+		value_type* try_get(entity_type& e)
+		{
+			size_type i = baseStorageType::find(e);
+			if (i == ENTITY_NULL_ID) return nullptr;
+			markPage(i);
+			baseStorageType::touch(i);
+			return &components[i];
+		}
+
+		/*
+		* @brief Returns e's component without checking that e owns one.
+		* @NOTE Only call this when e is known to be in the pool.
+		* @param e is a reference to an instance of Entity.
+		* @return A reference to e's component.
+		*/
+		value_type& get_unchecked(entity_type& e)
+		{
+			size_type i = baseStorageType::index_unchecked(e);
+			markPage(i);
+			baseStorageType::touch(i);
+			return components[i];
+		}
+
+		/*
+		* @brief Returns a pointer to the densely packed components. The component at
+		* i belongs to the entity at i of baseStorageType::entityData().
+		*/
+		value_type* componentData()
+		{
+			markAllPages();
+			baseStorageType::touchAll();
+			return components.data();
+		}
+
+		/*
+		* @brief Read only access to e's component. Unlike get it does not mark the 
+		* component as changed.
+		* @param e is a reference to an instance of Entity.
+		* @return A const reference to e's component.
+		*/
+		const value_type& read(entity_type& e)
+		{
+			return components[baseStorageType::index(e)];
+		}
+
+		/*
+		* @brief Read only access to the component at index i of the components vector.
+		* Does not mark its page as changed.
+		*/
+		const value_type& componentAt(size_type i) const
+		{
+			return components[i];
 		}
 
 		value_type& last()
@@ -113,6 +425,28 @@ namespace tent
 			return components.back();
 		}
 
+		/*
+		* @brief Turns tracking of changed pages on or off. While it is on every mutable
+		* access marks the page of the component it touched. Used by DoubleBuffer so only
+		* changed pages are copied when a snapshot is published. Starts with every page marked.
+		*/
+		void trackPages(bool enable)
+		{
+			trackingPages = enable;
+			dirtyPages.clear();
+			markAllPages();
+		}
+
+		bool isPageDirty(size_type page) const
+		{
+			return page >= dirtyPages.size() || dirtyPages[page] != 0;
+		}
+
+		void clearDirtyPages()
+		{
+			std::fill(dirtyPages.begin(), dirtyPages.end(), 0);
+		}
+
 		bool empty()
 		{
 			return components.empty();
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <Logi/Logi.h>
+
+#include "ComponentStorage.h"
+
+namespace tent
+{
+	/*
+	* @brief A read only copy of a Component pool as it was when it was published.
+	* The components are stored in pages that are shared with the previous snapshot
+	* when nothing in them changed. Safe to read from any thread while the pool
+	* it was taken from is written to.
+	*/
+	template<typename E, typename Component>
+	class Snapshot
+	{
+	public:
+		using entity_type = E;
+		using value_type = Component;
+		using size_type = std::size_t;
+
+		static constexpr size_type PAGE_SIZE{ ComponentStorage<E, Component>::PAGE_SIZE };
+
+	private:
+		template<typename, typename>
+		friend class DoubleBuffer;
+
+		struct DensePage
+		{
+			std::vector<entity_type> entities;
+			std::vector<value_type> components;
+		};
+
+		struct SparsePage
+		{
+			std::array<size_type, PAGE_SIZE> positions;
+		};
+
+		//pages are only written to before the snapshot is published.
+		std::vector<std::shared_ptr<DensePage>> dense;
+		std::vector<std::shared_ptr<SparsePage>> sparse; // map an entity index to its position in dense.
+		size_type count{ 0 };
+
+	public:
+		/*
+		* @brief Returns a pointer to the Component e owned when the snapshot was published.
+		* @param e is a reference to an instance of Entity.
+		* @return A pointer to the Component or nullptr if e did not own one.
+		*/
+		const value_type* get(const entity_type& e) const
+		{
+			size_type index = getEntityIndex(e);
+			if (index / PAGE_SIZE >= sparse.size() || sparse[index / PAGE_SIZE] == nullptr) return nullptr;
+			size_type position = sparse[index / PAGE_SIZE]->positions[index % PAGE_SIZE];
+			//positions of entities that left are not cleared so check the entity as well.
+			if (position >= count) return nullptr;
+			const DensePage& page = *dense[position / PAGE_SIZE];
+			if (!(page.entities[position % PAGE_SIZE] == e)) return nullptr;
+			return &page.components[position % PAGE_SIZE];
+		}
+
+		/*
+		* @brief Calls func(const entity_type&, const value_type&) for every Component in the snapshot.
+		*/
+		template<typename Func>
+		void each(Func&& func) const
+		{
+			for (const auto& page : dense)
+			{
+				for (size_type i = 0; i < page->entities.size(); i++)
+				{
+					func(page->entities[i], page->components[i]);
+				}
+			}
+		}
+
+		size_type size() const
+		{
+			return count;
+		}
+	};
+
+	/*
+	* @brief Type erased base so the Registry can publish every DoubleBuffer at once.
+	*/
+	class DoubleBufferBase
+	{
+	public:
+		virtual ~DoubleBufferBase() {}
+		virtual void publish() = 0;
+	};
+
+	/*
+	* @brief Keeps a published Snapshot of a Component pool for readers while writers keep
+	* changing the pool. publish copies only the pages the pool marked as changed, the rest
+	* are shared with the previous Snapshot.
+	*/
+	template<typename E, typename Component>
+	class DoubleBuffer : public DoubleBufferBase
+	{
+	public:
+		using storageType = ComponentStorage<E, Component>;
+		using snapshotType = Snapshot<E, Component>;
+		using size_type = std::size_t;
+
+	private:
+		static_assert(std::is_copy_constructible_v<Component>, "Double buffered Components have to be copy constructible.");
+		static constexpr size_type PAGE_SIZE{ snapshotType::PAGE_SIZE };
+
+		storageType* pool;
+		std::shared_ptr<const snapshotType> published;
+		//marks the sparse pages already copied during the current publish.
+		std::vector<uint8_t> sparseCopied;
+
+		void setPosition(snapshotType& next, size_type index, size_type position)
+		{
+			size_type page = index / PAGE_SIZE;
+			if (page >= next.sparse.size())
+			{
+				next.sparse.resize(page + 1u);
+				sparseCopied.resize(page + 1u, 0);
+			}
+			if (!sparseCopied[page])
+			{
+				auto copy = std::make_shared<typename snapshotType::SparsePage>();
+				if (next.sparse[page] != nullptr) copy->positions = next.sparse[page]->positions;
+				else copy->positions.fill(ENTITY_NULL_ID);
+				next.sparse[page] = copy;
+				sparseCopied[page] = 1;
+			}
+			next.sparse[page]->positions[index % PAGE_SIZE] = position;
+		}
+
+	public:
+		DoubleBuffer(storageType* _pool) : pool(_pool)
+		{
+			pool->trackPages(true);
+			publish();
+		}
+
+		~DoubleBuffer()
+		{
+			pool->trackPages(false);
+		}
+
+		/*
+		* @brief Publishes the current state of the pool as the new Snapshot. Pages
+		* that did not change since the last publish are shared, not copied.
+		* @NOTE Has to be called from the thread that writes to the pool.
+		*/
+		void publish() override
+		{
+			auto next = std::make_shared<snapshotType>();
+			std::shared_ptr<const snapshotType> previous = std::atomic_load(&published);
+			size_type previousPages{ 0 };
+			if (previous != nullptr)
+			{
+				next->dense = previous->dense;
+				next->sparse = previous->sparse;
+				previousPages = previous->dense.size();
+			}
+			sparseCopied.assign(next->sparse.size(), 0);
+
+			size_type size = pool->size();
+			size_type pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+			next->dense.resize(pages);
+			E* entities = pool->entityData();
+			for (size_type page = 0; page < pages; page++)
+			{
+				if (page < previousPages && !pool->isPageDirty(page)) continue;
+				auto copy = std::make_shared<typename snapshotType::DensePage>();
+				size_type first = page * PAGE_SIZE;
+				size_type last = std::min(first + PAGE_SIZE, size);
+				copy->entities.reserve(last - first);
+				copy->components.reserve(last - first);
+				for (size_type i = first; i < last; i++)
+				{
+					copy->entities.push_back(entities[i]);
+					copy->components.push_back(pool->componentAt(i));
+					setPosition(*next, getEntityIndex(entities[i]), i);
+				}
+				next->dense[page] = copy;
+			}
+			next->count = size;
+			pool->clearDirtyPages();
+			std::atomic_store(&published, std::shared_ptr<const snapshotType>(next));
+		}
+
+		/*
+		* @brief Returns the last published Snapshot. Safe to call from any thread.
+		* Readers keep the Snapshot alive for as long as they hold on to it.
+		*/
+		std::shared_ptr<const snapshotType> read() const
+		{
+			return std::atomic_load(&published);
+		}
+	};
+}
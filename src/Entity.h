@@ -1,60 +1,107 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
+#include <limits>
+#include <type_traits>
 
 namespace tent
 {
-	constexpr uint32_t MAX_INDEX_BITS { 22 };
-	constexpr uint32_t INDEX_MASK { (1 << MAX_INDEX_BITS) - 1 };
+	/*
+	* @brief Describes how an entity id is split into an index and a generation.
+	* The index is stored in the low IndexBits bits and the generation in the rest.
+	* @tparam EntityType is the unsigned integer an entity id is stored in.
+	* @tparam GenerationType has to be able to hold every generation.
+	* @tparam IndexBits is the number of bits used for the index.
+	*/
+	template<typename EntityType, typename GenerationType, uint32_t IndexBits>
+	struct EntityTraits
+	{
+		static_assert(std::is_unsigned_v<EntityType>, "Entity ids have to be unsigned.");
+		static_assert(IndexBits < sizeof(EntityType) * 8u, "The generation needs at least one bit.");
+
+		using entity_type = EntityType;
+		using generation_type = GenerationType;
+
+		static constexpr uint32_t index_bits{ IndexBits };
+		static constexpr uint32_t generation_bits{ sizeof(EntityType) * 8u - IndexBits };
+		static constexpr entity_type index_mask{ (entity_type(1) << index_bits) - 1u };
+		static constexpr entity_type generation_mask{ (entity_type(1) << generation_bits) - 1u };
+		static constexpr entity_type null_id{ std::numeric_limits<entity_type>::max() - 1u };
+
+		static_assert(generation_bits <= sizeof(GenerationType) * 8u, "GenerationType is too small for the generation bits.");
+	};
+
+	//about 4.2M live indices and 1024 generations in 4 bytes.
+	using EntityTraits32 = EntityTraits<uint32_t, uint16_t, 22>;
+	//about 4.2B live indices and 4.2B generations in 8 bytes.
+	using EntityTraits64 = EntityTraits<uint64_t, uint32_t, 32>;
+
+	constexpr uint32_t MAX_INDEX_BITS { EntityTraits32::index_bits };
+	constexpr uint32_t INDEX_MASK { EntityTraits32::index_mask };
 
-	constexpr uint32_t MAX_GENERATION_BITS { 32 - MAX_INDEX_BITS };
-	constexpr uint32_t GENERATION_MASK { (1 << MAX_GENERATION_BITS) - 1 };
+	constexpr uint32_t MAX_GENERATION_BITS { EntityTraits32::generation_bits };
+	constexpr uint32_t GENERATION_MASK { EntityTraits32::generation_mask };
 
-	using ENTITY_TYPE = uint32_t;
-	using GENERATION_TYPE = uint16_t;
-	constexpr uint32_t ENTITY_NULL_ID { UINT32_MAX - 1};
-	static uint32_t currentEntityIndexValue { 0 };
+	using ENTITY_TYPE = EntityTraits32::entity_type;
+	using GENERATION_TYPE = EntityTraits32::generation_type;
+	//null id of the default 32 bit Entity. Other layouts use BasicEntity::null_id.
+	constexpr uint32_t ENTITY_NULL_ID { EntityTraits32::null_id };
 
-	class Entity
+	template<typename Traits>
+	class BasicEntity
 	{
+	public:
+		using traits_type = Traits;
+		using entity_type = typename Traits::entity_type;
+		using generation_type = typename Traits::generation_type;
+
+		static constexpr entity_type null_id{ Traits::null_id };
+
 	private:
-		ENTITY_TYPE _id;
+		//shared by every Registry using these traits so ids stay unique across Registries.
+		//atomic so Registries can be filled on other threads, see AsyncLoader.
+		static inline std::atomic<entity_type> currentEntityIndexValue{ 0 };
+
+		entity_type _id;
 
 	public:
-		//Entity(bool _) : _id(ENTITY_NULL_ID) {}
-		Entity() : _id(currentEntityIndexValue++) {}
-		Entity(ENTITY_TYPE __ID) : _id(__ID) {}
-		Entity(const Entity& e) : _id(e._id) {}
-		Entity(Entity&& e) noexcept : _id(e._id) {}
-		operator ENTITY_TYPE() const { return _id; }
-		inline Entity& operator=(const Entity& e) { _id = e._id; return *this; }
-		//friend inline Entity createNullEntity() { return Entity(true);  }
-		friend inline ENTITY_TYPE getEntityID(const Entity& e) { return e._id; }
-		friend inline ENTITY_TYPE getEntityIndex(const Entity& e) { return e._id & INDEX_MASK; }
-		friend inline GENERATION_TYPE getEntityGeneration(const Entity& e) { return (e._id >> MAX_INDEX_BITS) & GENERATION_MASK; }
-		friend inline bool operator==(const Entity& e, uint32_t i) { return e._id == i; }
+		BasicEntity() : _id(currentEntityIndexValue.fetch_add(1, std::memory_order_relaxed)) {}
+		BasicEntity(entity_type __ID) : _id(__ID) {}
+		BasicEntity(const BasicEntity& e) : _id(e._id) {}
+		BasicEntity(BasicEntity&& e) noexcept : _id(e._id) {}
+		operator entity_type() const { return _id; }
+		inline BasicEntity& operator=(const BasicEntity& e) { _id = e._id; return *this; }
+		friend inline entity_type getEntityID(const BasicEntity& e) { return e._id; }
+		friend inline entity_type getEntityIndex(const BasicEntity& e) { return e._id & Traits::index_mask; }
+		friend inline generation_type getEntityGeneration(const BasicEntity& e) { return static_cast<generation_type>((e._id >> Traits::index_bits) & Traits::generation_mask); }
+		friend inline bool isNullEntity(const BasicEntity& e) { return e._id == Traits::null_id; }
+		friend inline bool operator==(const BasicEntity& e, entity_type i) { return e._id == i; }
 	};
 
-	inline bool operator == (const Entity& lhs, const Entity& rhs)
+	template<typename Traits>
+	inline bool operator == (const BasicEntity<Traits>& lhs, const BasicEntity<Traits>& rhs)
 	{
 		return getEntityIndex(lhs) == getEntityIndex(rhs) && getEntityGeneration(lhs) == getEntityGeneration(rhs);
 	}
 
-	inline bool operator != (const Entity& lhs, const Entity& rhs)
+	template<typename Traits>
+	inline bool operator != (const BasicEntity<Traits>& lhs, const BasicEntity<Traits>& rhs)
 	{
 		return !(lhs == rhs);
 	}
+
+	using Entity = BasicEntity<EntityTraits32>;
+	using Entity64 = BasicEntity<EntityTraits64>;
 }
 
 namespace std
 {
-	template<>
-	struct hash<tent::Entity>
+	template<typename Traits>
+	struct hash<tent::BasicEntity<Traits>>
 	{
-		std::size_t operator()(const tent::Entity& e) const
+		std::size_t operator()(const tent::BasicEntity<Traits>& e) const
 		{
-			return hash<tent::ENTITY_TYPE>()((tent::ENTITY_TYPE)e);
+			return hash<typename Traits::entity_type>()(getEntityID(e));
 		}
 	};
 }
-
-
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Entity.h"
+
+namespace tent
+{
+	/*
+	* @brief Built in Component that links an entity into a hierarchy. Children of
+	* an entity form a singly linked list starting at firstChild and continuing through
+	* nextSibling. Null links hold E::null_id.
+	* @NOTE Use Registry::setParent and Registry::removeParent to change the links
+	* so both ends stay in sync.
+	*/
+	template<typename E>
+	struct BasicRelationship
+	{
+		E parent{ E::null_id };
+		E firstChild{ E::null_id };
+		E nextSibling{ E::null_id };
+	};
+
+	using Relationship = BasicRelationship<Entity>;
+}
@@ -4,6 +4,9 @@
 #include "ComponentStorage.h"
 #include "Registry.h"
 #include "View.h"
+#include "Simulation.h"
+
+TENT_DEFINE_ALLOCATION_HOOKS()
 
 using namespace tent;
 
@@ -73,16 +76,9 @@ int main(int argc, char* argv[])
 			for (std::size_t i = 0; i < n_entities; i++)
 			{
 				auto& e = entities[i];
-				auto& c1 = reg.get<TestComponentOne>(e);
-				if (reg.exists<TestComponentTwo>(e))
-				{
-					auto& c2 = reg.get<TestComponentTwo>(e);
-				}
-
-				if (reg.exists<TestComponentThree>(e))
-				{
-					auto& c3 = reg.get<TestComponentThree>(e);
-				}
+				auto& c1 = reg.get_unchecked<TestComponentOne>(e);
+				auto* c2 = reg.try_get<TestComponentTwo>(e);
+				auto* c3 = reg.try_get<TestComponentThree>(e);
 			}
 		}
 		auto end = std::chrono::steady_clock::now();
@@ -111,6 +107,23 @@ int main(int argc, char* argv[])
 
 	}
 
+	{
+		SimulationConfig config;
+		config.entities = 100000;
+		config.spawnPerFrame = 1000;
+		config.killPerFrame = 1000;
+		Simulation<Entity> sim(config);
+		sim.addComponent<TestComponentOne>(1.0f).addComponent<TestComponentTwo>(0.5f).addComponent<TestComponentThree>(0.33f);
+		sim.addSystem("one_two", [](Registry& reg)
+			{
+				for (auto e : reg.view<TestComponentOne, TestComponentTwo>()) reg.get<TestComponentOne>(e).id++;
+			});
+		sim.addSystem("three", [](Registry& reg)
+			{
+				for (auto e : reg.view<TestComponentThree>(exclude<TestComponentTwo>)) reg.get<TestComponentThree>(e).id++;
+			});
+		sim.run().write(std::cout);
+	}
 
 	return 1;
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <Logi/Logi.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace tent
+{
+	/*
+	* @brief A vector whose elements live in a memory mapped temporary file instead of
+	* on the heap, so the OS pages them in and out and a pool can hold more data than
+	* fits in RAM. It grows by extending the file and mapping it again.
+	* Implements the part of std::vector that ComponentStorage and SparseSet use, so it
+	* can be passed as their Container or picked for a Component through storage_traits.
+	* @NOTE T has to be trivially copyable since the mapping can move in memory.
+	* Elements can only be inserted at the end.
+	*/
+	template<typename T>
+	class MappedVector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Memory mapped Components have to be trivially copyable.");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+	private:
+		T* items{ nullptr };
+		size_type count{ 0 };
+		size_type reserved{ 0 }; // elements the current mapping has room for.
+#ifdef _WIN32
+		HANDLE file{ INVALID_HANDLE_VALUE };
+		HANDLE mapping{ nullptr };
+#else
+		int file{ -1 };
+#endif
+
+		/*
+		* @brief The directory the backing files are created in. Defaults to the
+		* system's temporary directory.
+		*/
+		static std::string& directoryPath()
+		{
+			static std::string path;
+			return path;
+		}
+
+		void openFile()
+		{
+#ifdef _WIN32
+			char dir[MAX_PATH];
+			char name[MAX_PATH];
+			if (directoryPath().empty()) GetTempPathA(MAX_PATH, dir);
+			else strncpy_s(dir, directoryPath().c_str(), _TRUNCATE);
+			UINT created = GetTempFileNameA(dir, "tnt", 0, name);
+			ASSERT_FATAL(created != 0, "Could not create a file for a memory mapped pool.");
+			(void)created;
+			file = CreateFileA(name, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+				FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+			ASSERT_FATAL(file != INVALID_HANDLE_VALUE, "Could not create a file for a memory mapped pool.");
+#else
+			std::string name = directoryPath().empty() ? "/tmp" : directoryPath();
+			const char* tmp = std::getenv("TMPDIR");
+			if (directoryPath().empty() && tmp != nullptr) name = tmp;
+			name += "/tentXXXXXX";
+			file = mkstemp(&name[0]);
+			ASSERT_FATAL(file != -1, "Could not create a file for a memory mapped pool.");
+			//the file stays alive through the descriptor and is removed by the OS once it is closed.
+			unlink(name.c_str());
+#endif
+		}
+
+		void unmap()
+		{
+			if (items == nullptr) return;
+#ifdef _WIN32
+			UnmapViewOfFile(items);
+			CloseHandle(mapping);
+			mapping = nullptr;
+#else
+			munmap(items, reserved * sizeof(T));
+#endif
+			items = nullptr;
+		}
+
+		/*
+		* @brief Resizes the backing file to hold capacity elements and maps it again.
+		* The elements are kept by the file so nothing is copied.
+		*/
+		void remap(size_type capacity)
+		{
+			unmap();
+			reserved = capacity;
+			if (capacity == 0) return;
+#ifdef _WIN32
+			if (file == INVALID_HANDLE_VALUE) openFile();
+			unsigned long long bytes = static_cast<unsigned long long>(capacity) * sizeof(T);
+			//CreateFileMapping grows the file but never shrinks it.
+			LARGE_INTEGER size;
+			size.QuadPart = static_cast<LONGLONG>(bytes);
+			SetFilePointerEx(file, size, nullptr, FILE_BEGIN);
+			SetEndOfFile(file);
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(bytes >> 32), static_cast<DWORD>(bytes), nullptr);
+			ASSERT_FATAL(mapping != nullptr, "Could not map the file of a memory mapped pool.");
+			items = static_cast<T*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+			ASSERT_FATAL(items != nullptr, "Could not map the file of a memory mapped pool.");
+#else
+			if (file == -1) openFile();
+			int resized = ftruncate(file, static_cast<off_t>(capacity * sizeof(T)));
+			ASSERT_FATAL(resized == 0, "Could not grow the file of a memory mapped pool.");
+			(void)resized;
+			void* p = mmap(nullptr, capacity * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+			ASSERT_FATAL(p != MAP_FAILED, "Could not map the file of a memory mapped pool.");
+			items = static_cast<T*>(p);
+#endif
+		}
+
+		void grow(size_type needed)
+		{
+			if (needed <= reserved) return;
+			//start at a page worth of elements and double after that.
+			size_type capacity = reserved > 0 ? reserved * 2u : std::max<size_type>(4096u / sizeof(T), 1u);
+			while (capacity < needed) capacity *= 2u;
+			remap(capacity);
+		}
+
+		void release()
+		{
+			unmap();
+#ifdef _WIN32
+			if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+#else
+			if (file != -1) close(file);
+			file = -1;
+#endif
+			count = 0;
+			reserved = 0;
+		}
+
+	public:
+		MappedVector() {}
+		MappedVector(const MappedVector&) = delete;
+		MappedVector& operator=(const MappedVector&) = delete;
+
+		MappedVector(MappedVector&& o) noexcept
+		{
+			swap(o);
+		}
+
+		MappedVector& operator=(MappedVector&& o) noexcept
+		{
+			if (this != &o)
+			{
+				release();
+				swap(o);
+			}
+			return *this;
+		}
+
+		~MappedVector()
+		{
+			release();
+		}
+
+		/*
+		* @brief Sets the directory new backing files are created in, for example a
+		* large scratch disk. An empty path uses the system's temporary directory.
+		*/
+		static void setDirectory(const std::string& path)
+		{
+			directoryPath() = path;
+		}
+
+		void swap(MappedVector& o) noexcept
+		{
+			std::swap(items, o.items);
+			std::swap(count, o.count);
+			std::swap(reserved, o.reserved);
+			std::swap(file, o.file);
+#ifdef _WIN32
+			std::swap(mapping, o.mapping);
+#endif
+		}
+
+		void reserve(size_type capacity)
+		{
+			grow(capacity);
+		}
+
+		/*
+		* @brief Shrinks the backing file down to the elements in use.
+		*/
+		void shrink_to_fit()
+		{
+			if (count == reserved) return;
+			remap(count);
+		}
+
+		void push_back(const T& value)
+		{
+			//value can live in this vector so copy it before the mapping moves.
+			T copy(value);
+			grow(count + 1u);
+			new (items + count) T(copy);
+			count++;
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			T value(std::forward<Args>(args)...);
+			grow(count + 1u);
+			new (items + count) T(value);
+			return items[count++];
+		}
+
+		void pop_back()
+		{
+			count--;
+		}
+
+		/*
+		* @brief Appends n copies of value. pos has to be end().
+		*/
+		iterator insert(const_iterator pos, size_type n, const T& value)
+		{
+			ASSERT_ERROR(pos == cend(), "MappedVector only inserts at the end.");
+			(void)pos;
+			T copy(value);
+			size_type first = count;
+			grow(count + n);
+			for (size_type i = 0; i < n; i++) new (items + count + i) T(copy);
+			count += n;
+			return items + first;
+		}
+
+		/*
+		* @brief Appends the elements of [begin, end). pos has to be end().
+		*/
+		template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+		iterator insert(const_iterator pos, It begin, It end)
+		{
+			ASSERT_ERROR(pos == cend(), "MappedVector only inserts at the end.");
+			(void)pos;
+			size_type first = count;
+			grow(count + static_cast<size_type>(std::distance(begin, end)));
+			for (; begin != end; ++begin) new (items + count++) T(*begin);
+			return items + first;
+		}
+
+		void clear()
+		{
+			count = 0;
+		}
+
+		T& operator[](size_type i) { return items[i]; }
+		const T& operator[](size_type i) const { return items[i]; }
+
+		T& at(size_type i)
+		{
+			ASSERT_ERROR(i < count, "Index is out of bounds.");
+			return items[i];
+		}
+
+		T& back() { return items[count - 1u]; }
+		T* data() { return items; }
+		const T* data() const { return items; }
+
+		size_type size() const { return count; }
+		size_type capacity() const { return reserved; }
+		bool empty() const { return count == 0; }
+
+		iterator begin() { return items; }
+		iterator end() { return items + count; }
+		const_iterator begin() const { return items; }
+		const_iterator end() const { return items + count; }
+		const_iterator cbegin() const { return items; }
+		const_iterator cend() const { return items + count; }
+	};
+
+	template<typename T>
+	void swap(MappedVector<T>& a, MappedVector<T>& b) noexcept
+	{
+		a.swap(b);
+	}
+}
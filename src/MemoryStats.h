@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+namespace tent
+{
+	/*
+	* @brief Memory used by a single component pool. Bytes are what is in use and
+	* capacity bytes are what is allocated. Filled in by SparseSet::memoryStats.
+	*/
+	struct PoolMemoryStats
+	{
+		std::size_t componentId{ 0 };
+		std::size_t size{ 0 }; // live entities in the pool.
+		std::size_t peak{ 0 }; // most entities the pool has held at once.
+
+		std::size_t denseBytes{ 0 };
+		std::size_t denseCapacityBytes{ 0 };
+		std::size_t sparseBytes{ 0 };
+		std::size_t sparseCapacityBytes{ 0 };
+		std::size_t componentBytes{ 0 };
+		std::size_t componentCapacityBytes{ 0 };
+
+		std::size_t bytes() const { return denseBytes + sparseBytes + componentBytes; }
+		std::size_t capacityBytes() const { return denseCapacityBytes + sparseCapacityBytes + componentCapacityBytes; }
+		std::size_t slackBytes() const { return capacityBytes() - bytes(); }
+	};
+
+	/*
+	* @brief Memory used by a Registry and all of its pools. Filled in by Registry::memoryStats.
+	* @NOTE bookkeepingBytes is an estimate of the entity map, the recycle list and the
+	* pool table since the standard containers do not report their node sizes.
+	*/
+	struct RegistryMemoryStats
+	{
+		std::vector<PoolMemoryStats> pools;
+		std::size_t entities{ 0 }; // live entities in the Registry.
+		std::size_t peakEntities{ 0 };
+		std::size_t recycleableEntities{ 0 };
+		std::size_t bookkeepingBytes{ 0 };
+
+		std::size_t capacityBytes() const
+		{
+			std::size_t total{ bookkeepingBytes };
+			for (const PoolMemoryStats& p : pools) total += p.capacityBytes();
+			return total;
+		}
+
+		std::size_t slackBytes() const
+		{
+			std::size_t total{ 0 };
+			for (const PoolMemoryStats& p : pools) total += p.slackBytes();
+			return total;
+		}
+	};
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Profiling is compiled out unless TENT_PROFILING is defined project wide (it changes
+* the layout of View so every translation unit has to agree on it).
+* When it is disabled the macros below expand to nothing so instrumented code
+* pays nothing for them.
+*/
+#ifdef TENT_PROFILING
+#define TENT_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TENT_PROFILE_CONCAT(a, b) TENT_PROFILE_CONCAT_IMPL(a, b)
+#define TENT_PROFILE_SCOPE(name, owner) ::tent::ProfileScope TENT_PROFILE_CONCAT(tentProfileScope, __LINE__)(name, owner)
+#define TENT_PROFILE_COUNTER(name, owner, value) ::tent::Profiler::instance().counter(name, owner, value)
+#else
+#define TENT_PROFILE_SCOPE(name, owner)
+#define TENT_PROFILE_COUNTER(name, owner, value)
+#endif
+
+namespace tent
+{
+	/*
+	* @brief Collects timings and counters from the instrumented parts of Tent and
+	* writes them out as a Chrome/Perfetto trace. Every event records the address of the
+	* Registry, View or pool it came from as its owner.
+	*/
+	class Profiler
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+	private:
+		struct Event
+		{
+			const char* name;
+			const void* owner;
+			std::size_t thread;
+			double start; // microseconds since the profiler was created.
+			double duration; // negative for counters.
+			double value;
+		};
+
+		clock::time_point epoch{ clock::now() };
+		std::vector<Event> events;
+		std::mutex lock;
+
+		Profiler() {}
+
+		double toMicroseconds(clock::time_point t) const
+		{
+			return std::chrono::duration<double, std::micro>(t - epoch).count();
+		}
+
+		static std::size_t threadId()
+		{
+			return std::hash<std::thread::id>()(std::this_thread::get_id());
+		}
+
+	public:
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		static Profiler& instance()
+		{
+			static Profiler profiler;
+			return profiler;
+		}
+
+		/*
+		* @brief Records a timed scope. Called by ProfileScope.
+		* @param name has to outlive the profiler, string literals are expected.
+		*/
+		void scope(const char* name, const void* owner, clock::time_point start, clock::time_point end)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			events.push_back({ name, owner, threadId(), toMicroseconds(start), toMicroseconds(end) - toMicroseconds(start), 0.0 });
+		}
+
+		/*
+		* @brief Records the value of a counter at the current time.
+		* @param name has to outlive the profiler, string literals are expected.
+		*/
+		void counter(const char* name, const void* owner, double value)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			events.push_back({ name, owner, threadId(), toMicroseconds(clock::now()), -1.0, value });
+		}
+
+		std::size_t size()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			return events.size();
+		}
+
+		void clear()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			events.clear();
+		}
+
+		/*
+		* @brief Writes every recorded event to path in the Chrome trace event format
+		* which can be opened with chrome://tracing or ui.perfetto.dev.
+		* @param path is the file to write.
+		* @return false if the file could not be opened.
+		*/
+		bool writeChromeTrace(const std::string& path)
+		{
+			std::ofstream out(path);
+			if (!out.is_open()) return false;
+			out << std::fixed;
+			std::lock_guard<std::mutex> guard(lock);
+			out << "{\"traceEvents\":[";
+			for (std::size_t i = 0; i < events.size(); i++)
+			{
+				const Event& e = events[i];
+				if (i > 0) out << ",";
+				out << "{\"name\":\"" << e.name << "\",\"cat\":\"tent\",\"pid\":0,\"tid\":" << e.thread
+					<< ",\"ts\":" << e.start;
+				if (e.duration >= 0.0)
+				{
+					out << ",\"ph\":\"X\",\"dur\":" << e.duration
+						<< ",\"args\":{\"owner\":" << reinterpret_cast<std::uintptr_t>(e.owner) << "}}";
+				}
+				else
+				{
+					//counters are keyed by owner so each Registry or pool gets its own track.
+					out << ",\"ph\":\"C\",\"id\":" << reinterpret_cast<std::uintptr_t>(e.owner)
+						<< ",\"args\":{\"value\":" << e.value << "}}";
+				}
+			}
+			out << "]}";
+			return true;
+		}
+	};
+
+	/*
+	* @brief Times the scope it lives in and hands the result to the Profiler when destroyed.
+	* Use TENT_PROFILE_SCOPE instead of creating one directly.
+	*/
+	class ProfileScope
+	{
+	private:
+		const char* name;
+		const void* owner;
+		Profiler::clock::time_point start;
+
+	public:
+		ProfileScope(const char* _name, const void* _owner) : name(_name), owner(_owner), start(Profiler::clock::now()) {}
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+		~ProfileScope()
+		{
+			Profiler::instance().scope(name, owner, start, Profiler::clock::now());
+		}
+	};
+}
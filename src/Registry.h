@@ -1,7 +1,7 @@
 #pragma once
 #include <tuple>
+#include <algorithm>
 #include <vector>
-#include <list>
 #include <memory>
 #include <bitset>
 #include <unordered_map>
@@ -9,17 +9,33 @@
 
 #include "ComponentStorage.h"
 #include "Types.h"
+#include "Hierarchy.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
+#include "DoubleBuffer.h"
+#include "ComponentIndex.h"
 #include "View.h"
+#include "RuntimeView.h"
 
 namespace tent
 {
-	//template<std::size_t NumberOfComponents>
-	class Registry
+	/*
+	* @brief Owns the entities and every Component pool of a world.
+	* @tparam E is the entity type, its traits decide how many entities can be alive
+	* at once and how many generations an index goes through. Use Registry for the
+	* compact 32 bit Entity or BasicRegistry<Entity64> for very large worlds.
+	*/
+	template<typename E>
+	class BasicRegistry
 	{
+	public:
+		using entity_type = E;
+		using relationship_type = BasicRelationship<E>;
+
 	private:
 		template<typename Component>
-		using storageType = ComponentStorage<Entity, Component>;
-		using underlyingStorageType = SparseSet<Entity>;
+		using storageType = ComponentStorage<entity_type, Component>;
+		using underlyingStorageType = SparseSet<entity_type>;
 
 		struct sparseSetsData
 		{
@@ -30,20 +46,34 @@ namespace tent
 		};
 		//contains all of the component pools.
 		std::vector<sparseSetsData> sparseSets;
+		//views kept across frames, indexed by QueryIndex_v. Declared after sparseSets 
+		//so they are destroyed before the pools they point at.
+		std::vector<std::unique_ptr<View<entity_type>>> cachedViews;
+		//double buffers indexed by Component id. Declared after sparseSets for the same reason.
+		std::vector<std::unique_ptr<DoubleBufferBase>> doubleBuffers;
+		//secondary indexes indexed by Component id. Declared after sparseSets for the same reason.
+		std::vector<std::vector<std::unique_ptr<IndexBase<entity_type>>>> indexes;
 		//all entities in this map will be considered to exist.
 		//the bitset is used to track what components an entity does or 
 		//does not have.
-		static constexpr std::size_t numberOfComponents{ 10 };
+		static constexpr std::size_t numberOfComponents{ 32 };
 
 		//TODO this is pretty slow.
-		std::unordered_map<Entity, std::bitset<numberOfComponents>> entities;
+		std::unordered_map<entity_type, std::bitset<numberOfComponents>> entities;
 		//a linked list of entities to be reused.
-		std::list<Entity> recycleableEntites;
+		std::vector<entity_type> recycleableEntites;
+		//most entities that have been alive at once.
+		std::size_t peakEntities{ 0 };
+		//kill calls compact(compactSlack) every compactInterval kills. 0 disables it.
+		std::size_t compactInterval{ 0 };
+		std::size_t killsSinceCompact{ 0 };
+		float compactSlack{ 0.5f };
+		//additions and changes to Components are recorded with this tick.
+		uint32_t currentTick{ 1 };
+		//template entities spawned with spawn(). Created on first use.
+		std::unique_ptr<BasicRegistry> prefabRegistry;
 
 
-		std::function<void(Entity&, std::size_t)> l_remove = [=](Entity& e, std::size_t i)
-		{ getUnderlyingPool(i)->remove(e); };
-
 	private:
 
 		/*
@@ -66,10 +96,98 @@ namespace tent
 			{
 				sparseSets[index].init();
 				sparseSets[index].sparseSet.reset(new storageType<Component>());
+				sparseSets[index].sparseSet->setTick(currentTick);
 			}
 			return static_cast<storageType<Component>*>(sparseSets[index].sparseSet.get());
 		}
 
+		/*
+		* @brief Returns the component pool for the specified Component or nullptr
+		* if the pool has not been created yet.
+		* @tparam Component is the type of Component to get the pool for.
+		* @return A pointer to an instance of ComponentStorage<Entity, Component> or nullptr.
+		*/
+		template<typename Component>
+		storageType<Component>* tryGetPool()
+		{
+			std::size_t index = TypeIndex_v<Component>;
+			if (index >= sparseSets.size() || !sparseSets[index].initialized)
+			{
+				return nullptr;
+			}
+			return static_cast<storageType<Component>*>(sparseSets[index].sparseSet.get());
+		}
+
+		template<typename Component>
+		void clearPool()
+		{
+			storageType<Component>* pool = tryGetPool<Component>();
+			if (pool == nullptr) return;
+			//every link of a Relationship points at another Relationship in this pool so
+			//clearing the hierarchy does not have to unlink anything.
+			pool->clear();
+			std::size_t i = index<Component>();
+			if (i < indexes.size())
+			{
+				for (auto& idx : indexes[i]) idx->clear();
+			}
+		}
+
+		/*
+		* @brief Indexes e's Component with id i in every index on it, or updates its key.
+		*/
+		void indexInsert(std::size_t i, entity_type& e)
+		{
+			if (i >= indexes.size()) return;
+			for (auto& idx : indexes[i]) idx->insert(e);
+		}
+
+		void indexErase(std::size_t i, entity_type& e)
+		{
+			if (i >= indexes.size()) return;
+			for (auto& idx : indexes[i]) idx->erase(e);
+		}
+
+		template<typename Index, typename Component, typename Extractor>
+		Index& createIndex(Extractor&& extract)
+		{
+			std::size_t i = index<Component>();
+			if (i >= indexes.size())
+			{
+				indexes.resize(i + 1u);
+			}
+			Index* idx = new Index(getOrCreatePool<Component>(i), std::forward<Extractor>(extract));
+			indexes[i].emplace_back(idx);
+			return *idx;
+		}
+
+		/*
+		* @brief Adds a TickFilter to filters when Component is wrapped in Changed or Added.
+		* @tparam Component is a Component type from a View's Component list.
+		*/
+		template<typename Component>
+		void addTickFilter(std::vector<typename View<entity_type>::TickFilter>& filters)
+		{
+			using traits = filter_traits<std::remove_const_t<Component>>;
+			if constexpr (traits::changed || traits::added)
+			{
+				filters.push_back({ getUnderlyingPool(index<unwrap_t<Component>>()), traits::added });
+			}
+		}
+
+		/*
+		* @brief Adds the pool of Component to written when a View writes it, see writes_v.
+		* @tparam Component is a Component type from a View's Component list.
+		*/
+		template<typename Component>
+		void addWrite(std::vector<underlyingStorageType*>& written)
+		{
+			if constexpr (writes_v<Component>)
+			{
+				written.push_back(getUnderlyingPool(index<unwrap_t<Component>>()));
+			}
+		}
+
 		/*
 		* @brief Returns the underlying type the component pools.
 		* This is used to call methods of SparseSet<Entity> directly. instead of 
@@ -95,8 +213,8 @@ namespace tent
 		* @param func is a function reference that will be used to process the Type List.
 		* @return void.
 		*/
-		template<typename TList, typename E, typename Func>
-		void processTList(E&& e, Func&& func) //e and func are universal references
+		template<typename TList, typename EntityRef, typename Func>
+		void processTList(EntityRef&& e, Func&& func) //e and func are universal references
 		{
 			using head = head_t<TList>;
 			//if at the end of the type list the
@@ -115,7 +233,7 @@ namespace tent
 		* @param A reference to an instance of Entity.
 		* @return void.
 		*/
-		void _remove(Entity& e)
+		void _remove(entity_type& e)
 		{
 			entities.erase(getEntityID(e));
 			recycle(e);
@@ -127,11 +245,60 @@ namespace tent
 		* @param A reference to an instance of Entity.
 		* @return void.
 		*/
-		void recycle(const Entity& e)
+		void recycle(const entity_type& e)
 		{
 			recycleableEntites.push_back(e);
 		}
 
+		/*
+		* @brief Detaches e from its parent's list of children.
+		* @param pool is the Relationship pool and has to contain e.
+		* @param e is a reference to an instance of Entity.
+		* @return void.
+		*/
+		void unlinkParent(storageType<relationship_type>* pool, entity_type& e)
+		{
+			relationship_type& r = pool->get(e);
+			if (isNullEntity(r.parent)) return;
+			relationship_type& p = pool->get(r.parent);
+			if (p.firstChild == e)
+			{
+				p.firstChild = r.nextSibling;
+			}
+			else
+			{
+				entity_type sibling = p.firstChild;
+				while (pool->get(sibling).nextSibling != e)
+				{
+					sibling = pool->get(sibling).nextSibling;
+				}
+				pool->get(sibling).nextSibling = r.nextSibling;
+			}
+			r.parent = entity_type(entity_type::null_id);
+			r.nextSibling = entity_type(entity_type::null_id);
+		}
+
+		/*
+		* @brief Unlinks e from its parent and turns all of its children into roots.
+		* Called before e is removed from the Relationship pool.
+		* @param pool is the Relationship pool and has to contain e.
+		* @param e is a reference to an instance of Entity.
+		* @return void.
+		*/
+		void unlinkAll(storageType<relationship_type>* pool, entity_type& e)
+		{
+			unlinkParent(pool, e);
+			entity_type child = pool->get(e).firstChild;
+			while (!isNullEntity(child))
+			{
+				relationship_type& c = pool->get(child);
+				child = c.nextSibling;
+				c.parent = entity_type(entity_type::null_id);
+				c.nextSibling = entity_type(entity_type::null_id);
+			}
+			pool->get(e).firstChild = entity_type(entity_type::null_id);
+		}
+
 		template<typename Component>
 		bool existsComponent() 
 		{
@@ -148,42 +315,89 @@ namespace tent
 		}
 
 	public:
-		Registry() {}
-		~Registry() {}
+		BasicRegistry() {}
+		BasicRegistry(BasicRegistry&&) = default;
+		BasicRegistry& operator=(BasicRegistry&&) = default;
+		~BasicRegistry() {}
 
-		std::unordered_map<Entity, std::bitset<numberOfComponents>>::iterator begin() { return entities.begin(); }
-		std::unordered_map<Entity, std::bitset<numberOfComponents>>::iterator end() { return entities.end(); }
+		typename std::unordered_map<entity_type, std::bitset<numberOfComponents>>::iterator begin() { return entities.begin(); }
+		typename std::unordered_map<entity_type, std::bitset<numberOfComponents>>::iterator end() { return entities.end(); }
 
 		/*
 		* @brief Returns an instance of Entity that is either newly created
 		* or an instance that has been recycled from a destroyed Entity.
 		* @return An instance of Entity.
 		*/
-		Entity createEntity()
+		entity_type createEntity()
 		{
-			if (recycleableEntites.size() > 0)
-			{
-				Entity e = recycleableEntites.back();
-				entities[e] = std::bitset<numberOfComponents>();
-				recycleableEntites.pop_back();
-				return e;
-			}
-			else
+			//a new id is only drawn from the counter when there is nothing to recycle.
+			entity_type e = recycleableEntites.empty() ? entity_type() : recycleableEntites.back();
+			if (!recycleableEntites.empty()) recycleableEntites.pop_back();
+			entities[e] = std::bitset<numberOfComponents>();
+			//merge hands over recycled ids, so a recycled entity can raise the peak as well.
+			if (entities.size() > peakEntities) peakEntities = entities.size();
+			return e;
+		}
+
+		/*
+		* @brief Fills in the memory used by this Registry and each of its pools.
+		* out's pool vector is reused so polling every frame does not allocate once
+		* it has grown to the number of pools.
+		* @param out is the stats to fill in.
+		* @return void.
+		*/
+		void memoryStats(RegistryMemoryStats& out) const
+		{
+			out.pools.clear();
+			for (std::size_t i = 0; i < sparseSets.size(); i++)
 			{
-				Entity e;
-				entities[e] = std::bitset<numberOfComponents>();
-				return e;
+				if (!sparseSets[i].initialized) continue;
+				PoolMemoryStats pool;
+				pool.componentId = i;
+				sparseSets[i].sparseSet->memoryStats(pool);
+				out.pools.push_back(pool);
 			}
+			out.entities = entities.size();
+			out.peakEntities = peakEntities;
+			out.recycleableEntities = recycleableEntites.size();
+			//every map node holds its value and a next pointer.
+			using mapValue = std::pair<const entity_type, std::bitset<numberOfComponents>>;
+			out.bookkeepingBytes = entities.bucket_count() * sizeof(void*)
+				+ entities.size() * (sizeof(mapValue) + sizeof(void*))
+				+ recycleableEntites.capacity() * sizeof(entity_type)
+				+ sparseSets.capacity() * sizeof(sparseSetsData);
 		}
 
-		template<typename... Components>
-		View<Entity> view()
+		RegistryMemoryStats memoryStats() const
+		{
+			RegistryMemoryStats out;
+			memoryStats(out);
+			return out;
+		}
+
+		/*
+		* @brief Creates a View over every entity that owns all of Components and 
+		* none of Excluded. Syntax registry.view<A, B>(exclude<C, D>)
+		* A Component wrapped in Changed or Added only matches entities whose Component
+		* changed or was added after since. Syntax registry.view<A, Changed<B>>(exclude<C>, lastTick)
+		* With TENT_ACCESS_CHECKS the view writes the pools of its non const Components for
+		* as long as it lives and reads the rest. Syntax registry.view<A, const B>()
+		* @tparam Components are the Component types an entity is required to own.
+		* @tparam Excluded are the Component types an entity is not allowed to own.
+		* @param since is the tick Changed and Added Components are compared against.
+		* @return An instance of View<Entity>.
+		*/
+		template<typename... Components, typename... Excluded>
+		View<entity_type> view(exclude_t<Excluded...> = {}, uint32_t since = 0)
 		{
+			TENT_PROFILE_SCOPE("Registry::view", this);
 			std::vector<underlyingStorageType*> pools;
 		    std::vector<std::size_t> sparse;
-			using tlist = create_t<Components...>;
+			std::vector<underlyingStorageType*> excluded;
+			std::vector<typename View<entity_type>::TickFilter> filters;
+			using tlist = create_t<unwrap_t<Components>...>;
 
-			processTList<tlist>(Entity(), [&](Entity& e, std::size_t i)
+			processTList<tlist>(entity_type(entity_type::null_id), [&](entity_type&, std::size_t i)
 				{
 					if (i + 1 > sparse.size())
 					{
@@ -193,7 +407,283 @@ namespace tent
 					sparse[i] = pools.size() - 1;
 				});
 
-			return View<Entity>(pools, sparse);
+			processTList<create_t<Excluded...>>(entity_type(entity_type::null_id), [&](entity_type&, std::size_t i)
+				{
+					//a pool that was never created can not contain any entities.
+					if (i < sparseSets.size() && sparseSets[i].initialized)
+					{
+						excluded.push_back(getUnderlyingPool(i));
+					}
+				});
+
+			(addTickFilter<Components>(filters), ...);
+			std::vector<underlyingStorageType*> written;
+			(addWrite<Components>(written), ...);
+			return View<entity_type>(pools, sparse, excluded, filters, since, written);
+		}
+
+		template<typename... Components>
+		View<entity_type> view(uint32_t since)
+		{
+			return view<Components...>(exclude_t<>{}, since);
+		}
+
+		/*
+		* @brief Returns a View that is built on the first call and kept by the Registry.
+		* Later calls only refresh it (see View::refresh) so fetching it every frame
+		* does not allocate. Syntax registry.cachedView<A, B>(exclude<C, D>)
+		* @NOTE Entities passed to the view's remove are removed on the next call 
+		* instead of when the view goes out of scope.
+		* @tparam Components are the Component types an entity is required to own.
+		* @tparam Excluded are the Component types an entity is not allowed to own.
+		* @param since is the tick Changed and Added Components are compared against.
+		* @return A reference to the cached View<Entity>.
+		*/
+		template<typename... Components, typename... Excluded>
+		View<entity_type>& cachedView(exclude_t<Excluded...> = {}, uint32_t since = 0)
+		{
+			std::size_t key = QueryIndex_v<std::tuple<create_t<Components...>, exclude_t<Excluded...>>>;
+			if (key >= cachedViews.size())
+			{
+				cachedViews.resize(key + 1u);
+			}
+			if (cachedViews[key] == nullptr)
+			{
+				TENT_PROFILE_SCOPE("Registry::cachedView", this);
+				//create the pools up front so the view keeps seeing them as they fill.
+				std::vector<underlyingStorageType*> pools{ getOrCreatePool<unwrap_t<Components>>(index<unwrap_t<Components>>())... };
+				std::vector<underlyingStorageType*> excluded{ getOrCreatePool<Excluded>(index<Excluded>())... };
+				std::vector<typename View<entity_type>::TickFilter> filters;
+				(addTickFilter<Components>(filters), ...);
+				std::vector<std::size_t> ids{ index<unwrap_t<Components>>()... };
+				std::vector<std::size_t> sparse;
+				for (std::size_t i = 0; i < ids.size(); i++)
+				{
+					if (ids[i] + 1 > sparse.size())
+					{
+						sparse.resize(ids[i] + 1u);
+					}
+					sparse[ids[i]] = i;
+				}
+				cachedViews[key].reset(new View<entity_type>(pools, sparse, excluded, filters, since));
+#ifdef TENT_ACCESS_CHECKS
+				//a cached view outlives the frame it was made in so it does not hold on to its pools.
+				cachedViews[key]->releaseAccess();
+#endif
+			}
+			else
+			{
+				cachedViews[key]->refresh(since);
+			}
+			return *cachedViews[key];
+		}
+
+		template<typename... Components>
+		View<entity_type>& cachedView(uint32_t since)
+		{
+			return cachedView<Components...>(exclude_t<>{}, since);
+		}
+
+		/*
+		* @brief Returns the tick additions and changes are currently recorded with.
+		*/
+		uint32_t tick() const
+		{
+			return currentTick;
+		}
+
+		/*
+		* @brief Starts a new tick. A system calls this when it starts and passes the tick
+		* it got on its previous run to its Changed and Added views, so it sees every 
+		* change made since it last ran except its own.
+		* @return The new tick.
+		*/
+		uint32_t advanceTick()
+		{
+			currentTick++;
+			for (auto& sp : sparseSets)
+			{
+				if (sp.initialized) sp.sparseSet->setTick(currentTick);
+			}
+			return currentTick;
+		}
+
+		/*
+		* @brief Marks e's Component as changed during the current tick.
+		* @tparam Component is the type of Component that changed.
+		* @param e is a reference to an instance of Entity.
+		* @return void.
+		*/
+		template<typename Component>
+		void patch(entity_type& e)
+		{
+			TENT_ACCESS_WRITE(getUnderlyingPool(index<Component>())->access(), "Registry::patch");
+			getUnderlyingPool(index<Component>())->patch(e);
+			indexInsert(index<Component>(), e);
+		}
+
+		/*
+		* @brief Calls func with e's Component and marks it as changed during the current tick.
+		* @tparam Component is the type of Component to change.
+		* @param e is a reference to an instance of Entity.
+		* @param func is called as func(Component&).
+		* @return void.
+		*/
+		template<typename Component, typename Func>
+		void patch(entity_type& e, Func&& func)
+		{
+			func(get<Component>(e));
+			indexInsert(index<Component>(), e);
+		}
+
+		/*
+		* @brief Returns a const reference to the instance of Component that e owns. 
+		* Unlike get it does not mark the Component as changed.
+		* @tparam Component is the type to return and instance of.
+		* @param e is a reference to an instance of Entity.
+		* @return A const reference to an instance of Component that e owns.
+		*/
+		template<typename Component>
+		const Component& read(entity_type& e)
+		{
+			storageType<Component>* pool = tryGetPool<Component>();
+			ASSERT_FATAL(pool != nullptr, "Entity does not own this Component.");
+			TENT_ACCESS_READ(pool->access(), "Registry::read");
+			return pool->read(e);
+		}
+
+		/*
+		* @brief Makes the pools of Components keep a bitmap of their entity indices. Views
+		* over several of them intersect the bitmaps instead of probing every entity when
+		* the pools are large and the query is selective.
+		* @tparam Components are the Component types whose pools keep a bitmap.
+		* @param enable turns the bitmaps off again when false.
+		* @return void.
+		*/
+		template<typename... Components>
+		void enableBitmap(bool enable = true)
+		{
+			(getOrCreatePool<Components>(index<Components>())->enableBitmap(enable), ...);
+		}
+
+		/*
+		* @brief Creates a hash index from the key extract returns for each Component to the
+		* entities owning it, so finding entities by Component value is O(1) on average.
+		* The Registry keeps it up to date on push, emplace_back, patch, remove, kill,
+		* clear, merge and clone. Syntax:
+		* auto& byId = registry.addIndex<NetworkId>([](const NetworkId& n) { return n.id; });
+		* Entity e = byId.find(42);
+		* @NOTE Changes made through get or a View are only picked up once the Component is patched.
+		* @tparam Component is the type of Component to index.
+		* @param extract is called as extract(const Component&) and returns the key.
+		* @return A reference to the index. It lives as long as the Registry.
+		*/
+		template<typename Component, typename Extractor>
+		HashIndex<entity_type, Component, index_key_t<Component, Extractor>>& addIndex(Extractor&& extract)
+		{
+			using indexType = HashIndex<entity_type, Component, index_key_t<Component, Extractor>>;
+			return createIndex<indexType, Component>(std::forward<Extractor>(extract));
+		}
+
+		/*
+		* @brief Same as addIndex but the keys are kept sorted, lookups are O(log n) and
+		* the index can be walked by key range. Syntax: byCell.range(first, last, func)
+		*/
+		template<typename Component, typename Extractor>
+		OrderedIndex<entity_type, Component, index_key_t<Component, Extractor>>& addOrderedIndex(Extractor&& extract)
+		{
+			using indexType = OrderedIndex<entity_type, Component, index_key_t<Component, Extractor>>;
+			return createIndex<indexType, Component>(std::forward<Extractor>(extract));
+		}
+
+		/*
+		* @brief Turns on double buffering for Component. Readers on other threads can then 
+		* read the state published by the last call to publish() through snapshot<Component>()
+		* while the pool keeps being written to.
+		* @tparam Component is the type of Component to double buffer. It has to be copy constructible.
+		* @return void.
+		*/
+		template<typename Component>
+		void enableDoubleBuffer()
+		{
+			std::size_t i = index<Component>();
+			if (i >= doubleBuffers.size())
+			{
+				doubleBuffers.resize(i + 1u);
+			}
+			if (doubleBuffers[i] == nullptr)
+			{
+				doubleBuffers[i].reset(new DoubleBuffer<entity_type, Component>(getOrCreatePool<Component>(i)));
+			}
+		}
+
+		/*
+		* @brief Publishes a new Snapshot of every double buffered pool. Only the pages
+		* that changed since the last publish are copied.
+		* @NOTE Has to be called from the thread that writes to the pools, usually at the end of a tick.
+		* @return void.
+		*/
+		void publish()
+		{
+			TENT_PROFILE_SCOPE("Registry::publish", this);
+			for (auto& buffer : doubleBuffers)
+			{
+				if (buffer != nullptr) buffer->publish();
+			}
+		}
+
+		/*
+		* @brief Returns the last published Snapshot of Component. Safe to call from any thread.
+		* @tparam Component is a double buffered type of Component.
+		* @return A shared pointer to the read only Snapshot.
+		*/
+		template<typename Component>
+		std::shared_ptr<const Snapshot<entity_type, Component>> snapshot() const
+		{
+			std::size_t i = TypeIndex_v<Component>;
+			ASSERT_FATAL(i < doubleBuffers.size() && doubleBuffers[i] != nullptr, "Component is not double buffered.");
+			return static_cast<DoubleBuffer<entity_type, Component>*>(doubleBuffers[i].get())->read();
+		}
+
+		/*
+		* @brief Creates a RuntimeView from Component ids that are only known at runtime.
+		* Ids can be looked up with index<Component>().
+		* @param include are the ids of the Components an entity is required to own.
+		* @param exclude are the ids of the Components an entity is not allowed to own.
+		* @return An instance of RuntimeView<Entity>. If a required Component has no pool
+		* the view is empty.
+		*/
+		RuntimeView<entity_type> runtime_view(const std::vector<std::size_t>& include, const std::vector<std::size_t>& exclude = {})
+		{
+			TENT_PROFILE_SCOPE("Registry::runtime_view", this);
+			std::vector<underlyingStorageType*> pools;
+			std::vector<std::size_t> sparse;
+			std::vector<underlyingStorageType*> excluded;
+
+			for (std::size_t i : include)
+			{
+				if (i >= sparseSets.size() || !sparseSets[i].initialized)
+				{
+					return RuntimeView<entity_type>({}, {}, {});
+				}
+				if (i + 1 > sparse.size())
+				{
+					sparse.resize(i + 1u, ENTITY_NULL_ID);
+				}
+				pools.push_back(getUnderlyingPool(i));
+				sparse[i] = pools.size() - 1;
+			}
+
+			for (std::size_t i : exclude)
+			{
+				//a pool that was never created can not contain any entities.
+				if (i < sparseSets.size() && sparseSets[i].initialized)
+				{
+					excluded.push_back(getUnderlyingPool(i));
+				}
+			}
+
+			return RuntimeView<entity_type>(pools, sparse, excluded);
 		}
 
 		/*
@@ -205,7 +695,7 @@ namespace tent
 		* @return void.
 		*/
 		template<typename Component>
-		void push(Entity& e, Component& c)
+		void push(entity_type& e, Component& c)
 		{
 			push(e, std::move(c));
 		}
@@ -219,9 +709,10 @@ namespace tent
 		* @return void.
 		*/
 		template<typename Component>
-		void push(Entity& e, Component&& c)
+		void push(entity_type& e, Component&& c)
 		{
 			getOrCreatePool<Component>(index<Component>())->push(e, std::move(c));
+			indexInsert(index<Component>(), e);
 		}
 
 		/*
@@ -236,33 +727,116 @@ namespace tent
 		* @return void.
 		*/
 		template<typename Component, typename ...Args>
-		void emplace_back(Entity& e, Args&& ... args)
+		void emplace_back(entity_type& e, Args&& ... args)
 		{
 			getOrCreatePool<Component>(index<Component>())->emplace_back<Args...>(e, std::forward<Args>(args)...);
+			indexInsert(index<Component>(), e);
 		}
 
 		/*
 		* @brief Returns a reference to an instance of Component that e owns.
+		* @NOTE TENT_ACCESS_CHECKS only covers the lookup, not writes made through the returned
+		* reference later on. Systems that run on several threads should write through a View,
+		* which holds its write for as long as it lives.
 		* @tparam Component is the type to return and instance of.
 		* @param e is a reference to an instance of Entity.
 		* @return A reference to an instance of Component that e owns.
 		*/
 		template<typename Component>
-		Component& get(Entity& e)
+		Component& get(entity_type& e)
 		{
 			std::size_t index = TypeIndex_v<Component>;
 			ASSERT_FATAL(index < sparseSets.size(), "Index out of bounds or argument e is not the correct type.");
+			TENT_ACCESS_WRITE(sparseSets[index].sparseSet->access(), "Registry::get");
 			return static_cast<storageType<Component>*>(sparseSets[index].sparseSet.get())->get(e);
 		}
 
+		/*
+		* @brief Returns a pointer to the instance of Component that e owns or nullptr
+		* if e does not own one. Replaces calling exists<Component>(e) followed by get<Component>(e).
+		* @NOTE Access checks cover the same as get's.
+		* @tparam Component is the type to return a pointer to.
+		* @param e is a reference to an instance of Entity.
+		* @return A pointer to an instance of Component or nullptr.
+		*/
+		template<typename Component>
+		Component* try_get(entity_type& e)
+		{
+			storageType<Component>* pool = tryGetPool<Component>();
+			if (pool == nullptr) return nullptr;
+			TENT_ACCESS_WRITE(pool->access(), "Registry::try_get");
+			return pool->try_get(e);
+		}
+
+		/*
+		* @brief Takes in 2 to n Component types and returns a tuple of references to the
+		* instances of them that e owns. e is validated once and each pool is only resolved once.
+		* @tparam FirstComponent is the first type of Component to return.
+		* @tparam SecondComponent is the second type of Component to return.
+		* @tparam Components is a varying size of type Component to return.
+		* @param e is a reference to an instance of Entity.
+		* @return A tuple of references to the Components that e owns in the requested order.
+		*/
+		template<typename FirstComponent, typename SecondComponent, typename... Components>
+		std::tuple<FirstComponent&, SecondComponent&, Components&...> get(entity_type& e)
+		{
+			ASSERT_ERROR(exists(e), "Entity does not exist.");
+			ASSERT_ERROR((exists<FirstComponent>(e) && exists<SecondComponent>(e) && (exists<Components>(e) && ...)), 
+				"Entity does not own all of the requested components.");
+			return std::forward_as_tuple(get_unchecked<FirstComponent>(e), get_unchecked<SecondComponent>(e), get_unchecked<Components>(e)...);
+		}
+
+		/*
+		* @brief Takes in 2 to n Component types and returns a tuple of pointers to the
+		* instances of them that e owns. e has to be alive and is validated once.
+		* @tparam FirstComponent is the first type of Component to return.
+		* @tparam SecondComponent is the second type of Component to return.
+		* @tparam Components is a varying size of type Component to return.
+		* @param e is a reference to an instance of Entity.
+		* @return A tuple of pointers in the requested order, a pointer is nullptr when e
+		* does not own that Component.
+		*/
+		template<typename FirstComponent, typename SecondComponent, typename... Components>
+		std::tuple<FirstComponent*, SecondComponent*, Components*...> try_get(entity_type& e)
+		{
+			ASSERT_ERROR(exists(e), "Entity does not exist.");
+			return std::make_tuple(try_get<FirstComponent>(e), try_get<SecondComponent>(e), try_get<Components>(e)...);
+		}
+
+		/*
+		* @brief Returns a reference to an instance of Component that e owns without
+		* checking that e owns one.
+		* @NOTE Only call this when e is known to own a Component. Access checks cover the same as get's.
+		* @tparam Component is the type to return and instance of.
+		* @param e is a reference to an instance of Entity.
+		* @return A reference to an instance of Component that e owns.
+		*/
+		template<typename Component>
+		Component& get_unchecked(entity_type& e)
+		{
+			TENT_ACCESS_WRITE(sparseSets[TypeIndex_v<Component>].sparseSet->access(), "Registry::get_unchecked");
+			return static_cast<storageType<Component>*>(sparseSets[TypeIndex_v<Component>].sparseSet.get())->get_unchecked(e);
+		}
+
 		/*
 		* @brief Removes e from the Registry and from all of the Component pools.
 		* @param e is a reference to an instance of Entity.
 		* @return void.
 		*/
-		void kill(Entity& e)
+		void kill(entity_type& e)
 		{
+			TENT_PROFILE_SCOPE("Registry::kill", this);
 			ASSERT_ERROR(exists(e), "Entity does not exist.");
+			//keep the hierarchy from pointing at e after it is gone.
+			storageType<relationship_type>* relationships = tryGetPool<relationship_type>();
+			if (relationships != nullptr && relationships->exists(e))
+			{
+				unlinkAll(relationships, e);
+			}
+			for (std::size_t i = 0; i < indexes.size(); i++)
+			{
+				indexErase(i, e);
+			}
 			for (auto& sparseSet : sparseSets)
 			{
 				auto&& sp = sparseSet;
@@ -274,7 +848,466 @@ namespace tent
 			}
 			//remove e from unordered_map
 			_remove(e);
+			TENT_PROFILE_COUNTER("Registry::entities", this, static_cast<double>(entities.size()));
+			if (compactInterval > 0 && ++killsSinceCompact >= compactInterval)
+			{
+				compact(compactSlack);
+			}
+		}
+
+		/*
+		* @brief Releases memory the pools no longer need. A pool is trimmed when more
+		* than minSlack of its allocated bytes are unused. Recycleable entities are sorted so
+		* the lowest indices are reused first which keeps the sparse vectors short.
+		* @param minSlack is the fraction of unused bytes (0 to 1) a pool needs before it is trimmed.
+		* @return void.
+		*/
+		void compact(float minSlack = 0.0f)
+		{
+			TENT_PROFILE_SCOPE("Registry::compact", this);
+			killsSinceCompact = 0;
+			for (auto& sp : sparseSets)
+			{
+				if (!sp.initialized) continue;
+				PoolMemoryStats stats;
+				sp.sparseSet->memoryStats(stats);
+				if (stats.slackBytes() > minSlack * stats.capacityBytes())
+				{
+					sp.sparseSet->compact();
+				}
+			}
+			//createEntity reuses from the back of the list.
+			std::sort(recycleableEntites.begin(), recycleableEntites.end(), [](const entity_type& a, const entity_type& b) { return getEntityIndex(a) > getEntityIndex(b); });
+		}
+
+		/*
+		* @brief Kills every entity and empties every pool while keeping their allocations,
+		* so refilling the Registry afterwards does not have to grow the pools again.
+		* The killed entities are recycled, lowest index first. Cached views, double buffers
+		* and prefabs are kept.
+		* @NOTE The pools and the recycle list keep their allocations. The alive set is a hash
+		* map that frees a node per entity, so createEntity allocates one again.
+		* @return void.
+		*/
+		void clear()
+		{
+			TENT_PROFILE_SCOPE("Registry::clear", this);
+			for (auto& sp : sparseSets)
+			{
+				if (sp.initialized) sp.sparseSet->clear();
+			}
+			for (auto& list : indexes)
+			{
+				for (auto& idx : list) idx->clear();
+			}
+			recycleableEntites.reserve(recycleableEntites.size() + entities.size());
+			for (auto& pair : entities)
+			{
+				recycle(pair.first);
+			}
+			entities.clear();
+			std::sort(recycleableEntites.begin(), recycleableEntites.end(), [](const entity_type& a, const entity_type& b) { return getEntityIndex(a) > getEntityIndex(b); });
+			TENT_PROFILE_COUNTER("Registry::entities", this, 0.0);
+		}
+
+		/*
+		* @brief Empties the pools of Components while keeping their allocations. The 
+		* entities stay alive.
+		* @tparam Components are the Component types to remove from every entity.
+		* @return void.
+		*/
+		template<typename FirstComponent, typename... Components>
+		void clear()
+		{
+			TENT_PROFILE_SCOPE("Registry::clear", this);
+			clearPool<FirstComponent>();
+			(clearPool<Components>(), ...);
+		}
+
+		/*
+		* @brief Makes kill call compact(minSlack) after every interval kills so memory is 
+		* given back after mass despawns without having to call compact by hand.
+		* @param interval is the number of kills between compactions. 0 disables it.
+		* @param minSlack is the fraction of unused bytes (0 to 1) a pool needs before it is trimmed.
+		* @return void.
+		*/
+		void setCompactionPolicy(std::size_t interval, float minSlack = 0.5f)
+		{
+			compactInterval = interval;
+			compactSlack = minSlack;
+			killsSinceCompact = 0;
+		}
+		/*
+		* @brief Moves every entity and Component of other into this Registry. Pools this
+		* Registry does not have yet are taken over as a whole, the rest are appended to in
+		* one bulk move per pool. The merged Components count as added during the current tick.
+		* @NOTE Entity ids come from a process wide counter so two Registries never hand out 
+		* the same id and entities keep their ids, which keeps Relationship links valid.
+		* @param other is the Registry to merge. It is empty afterwards.
+		* @return void.
+		*/
+		void merge(BasicRegistry& other)
+		{
+			TENT_PROFILE_SCOPE("Registry::merge", this);
+			ASSERT_ERROR(&other != this, "Cannot merge a Registry with itself.");
+			//other's cached views and double buffers would point at pools that are moved or destroyed.
+			other.cachedViews.clear();
+			other.doubleBuffers.clear();
+			other.indexes.clear();
+			if (other.sparseSets.size() > sparseSets.size())
+			{
+				sparseSets.resize(other.sparseSets.size());
+			}
+			for (std::size_t i = 0; i < other.sparseSets.size(); i++)
+			{
+				sparseSetsData& theirs = other.sparseSets[i];
+				if (!theirs.initialized) continue;
+				if (!sparseSets[i].initialized)
+				{
+					sparseSets[i] = std::move(theirs);
+					sparseSets[i].sparseSet->adoptTick(currentTick);
+				}
+				else
+				{
+					getUnderlyingPool(i)->append(*theirs.sparseSet);
+				}
+			}
+			entities.reserve(entities.size() + other.entities.size());
+			entities.insert(other.entities.begin(), other.entities.end());
+			for (auto& pair : other.entities)
+			{
+				entity_type e = pair.first;
+				for (std::size_t i = 0; i < indexes.size(); i++) indexInsert(i, e);
+			}
+			if (entities.size() > peakEntities) peakEntities = entities.size();
+			recycleableEntites.insert(recycleableEntites.end(), other.recycleableEntites.begin(), other.recycleableEntites.end());
+			other.recycleableEntites.clear();
+			other.sparseSets.clear();
+			other.entities.clear();
+		}
+
+		/*
+		* @brief Moves up to maxEntities of other's entities and their Components into this
+		* Registry so a large Registry can be merged over several frames. Relationship 
+		* Components are held back until the last call so a hierarchy only shows up once 
+		* all of its entities have.
+		* @NOTE other has to stay untouched between calls.
+		* @param other is the Registry to merge in. It is empty once this returns true.
+		* @param maxEntities is the most entities to move in this call.
+		* @return true once every entity of other has been merged.
+		*/
+		bool mergeIncremental(BasicRegistry& other, std::size_t maxEntities)
+		{
+			TENT_PROFILE_SCOPE("Registry::mergeIncremental", this);
+			ASSERT_ERROR(&other != this, "Cannot merge a Registry with itself.");
+			other.cachedViews.clear();
+			other.doubleBuffers.clear();
+			other.indexes.clear();
+			std::size_t relationships = index<relationship_type>();
+			if (other.sparseSets.size() > sparseSets.size())
+			{
+				sparseSets.resize(other.sparseSets.size());
+			}
+			for (std::size_t i = 0; i < other.sparseSets.size(); i++)
+			{
+				if (!other.sparseSets[i].initialized || sparseSets[i].initialized) continue;
+				sparseSets[i].init();
+				sparseSets[i].sparseSet = other.sparseSets[i].sparseSet->createEmpty();
+				sparseSets[i].sparseSet->setTick(currentTick);
+			}
+
+			std::size_t moved{ 0 };
+			auto it = other.entities.begin();
+			while (it != other.entities.end() && moved < maxEntities)
+			{
+				entity_type e = it->first;
+				for (std::size_t i = 0; i < other.sparseSets.size(); i++)
+				{
+					if (!other.sparseSets[i].initialized || i == relationships) continue;
+					other.getUnderlyingPool(i)->moveTo(*getUnderlyingPool(i), e);
+				}
+				for (std::size_t i = 0; i < indexes.size(); i++)
+				{
+					if (i != relationships) indexInsert(i, e);
+				}
+				entities.insert(*it);
+				it = other.entities.erase(it);
+				moved++;
+			}
+			if (entities.size() > peakEntities) peakEntities = entities.size();
+			if (!other.entities.empty()) return false;
+
+			if (relationships < other.sparseSets.size() && other.sparseSets[relationships].initialized)
+			{
+				getUnderlyingPool(relationships)->append(*other.sparseSets[relationships].sparseSet);
+				if (relationships < indexes.size())
+				{
+					for (auto& idx : indexes[relationships]) idx->rebuild();
+				}
+			}
+			recycleableEntites.insert(recycleableEntites.end(), other.recycleableEntites.begin(), other.recycleableEntites.end());
+			other.recycleableEntites.clear();
+			other.sparseSets.clear();
+			return true;
+		}
+
+		/*
+		* @brief Moves the given entities and their Components out of this Registry into a new one.
+		* Each pool gathers the extracted entities at its end and moves them out in one range.
+		* Relationship links to entities that are not extracted are cut on both sides.
+		* @param toExtract are the entities to move. They have to exist in this Registry, duplicates are moved once.
+		* @return A Registry that owns the extracted entities.
+		*/
+		BasicRegistry extract(std::vector<entity_type>& toExtract)
+		{
+			TENT_PROFILE_SCOPE("Registry::extract", this);
+			BasicRegistry out;
+			//out's alive set doubles as the set of selected entities.
+			std::vector<entity_type> selected;
+			selected.reserve(toExtract.size());
+			out.entities.reserve(toExtract.size());
+			for (entity_type& e : toExtract)
+			{
+				ASSERT_ERROR(exists(e), "Entity does not exist.");
+				auto it = entities.find(e);
+				//entities listed twice are only moved once.
+				if (it == entities.end() || !out.entities.insert(*it).second) continue;
+				selected.push_back(e);
+			}
+
+			storageType<relationship_type>* relationships = tryGetPool<relationship_type>();
+			if (relationships != nullptr)
+			{
+				for (entity_type& e : selected)
+				{
+					if (!relationships->exists(e)) continue;
+					relationship_type& r = relationships->get(e);
+					if (!isNullEntity(r.parent) && !out.exists(r.parent))
+					{
+						unlinkParent(relationships, e);
+					}
+					entity_type child = relationships->get(e).firstChild;
+					while (!isNullEntity(child))
+					{
+						entity_type next = relationships->get(child).nextSibling;
+						if (!out.exists(child))
+						{
+							unlinkParent(relationships, child);
+						}
+						child = next;
+					}
+				}
+			}
+
+			out.sparseSets.resize(sparseSets.size());
+			for (std::size_t i = 0; i < sparseSets.size(); i++)
+			{
+				if (!sparseSets[i].initialized) continue;
+				underlyingStorageType* pool = getUnderlyingPool(i);
+				std::size_t tail = pool->size();
+				for (entity_type& e : selected)
+				{
+					if (!pool->exists(e)) continue;
+					tail--;
+					pool->swap(e, pool->entityData()[tail]);
+				}
+				if (tail == pool->size()) continue;
+				if (!out.sparseSets[i].initialized)
+				{
+					out.sparseSets[i].init();
+					out.sparseSets[i].sparseSet = pool->createEmpty();
+					out.sparseSets[i].sparseSet->setTick(out.currentTick);
+				}
+				pool->moveTailTo(*out.sparseSets[i].sparseSet, tail);
+			}
+
+			for (entity_type& e : selected)
+			{
+				for (std::size_t i = 0; i < indexes.size(); i++) indexErase(i, e);
+				entities.erase(e);
+			}
+			return out;
+		}
+
+		/*
+		* @brief Creates count copies of source that each own a copy of every Component
+		* source owns. Every pool is grown once and filled with a single bulk insert.
+		* @NOTE Every Component source owns has to be copy constructible, otherwise nothing
+		* is created. Relationship Components are not copied so the copies start out without
+		* a parent or children.
+		* @param source is the entity to copy. It has to exist in this Registry.
+		* @param count is the number of copies.
+		* @param out is an output iterator the new entities are written to.
+		* @return void.
+		*/
+		template<typename OutIt>
+		void clone(entity_type& source, std::size_t count, OutIt out)
+		{
+			clone(*this, source, count, out);
+		}
+
+		/*
+		* @brief Same as clone(source, count, out) but source lives in the Registry from.
+		* Pools this Registry does not have yet are created.
+		* @param from is the Registry that owns source, usually prefabs().
+		*/
+		template<typename OutIt>
+		void clone(BasicRegistry& from, entity_type& source, std::size_t count, OutIt out)
+		{
+			TENT_PROFILE_SCOPE("Registry::clone", this);
+			ASSERT_ERROR(from.exists(source), "Entity does not exist.");
+			std::size_t relationships = index<relationship_type>();
+			for (std::size_t i = 0; i < from.sparseSets.size(); i++)
+			{
+				if (!from.sparseSets[i].initialized || i == relationships) continue;
+				underlyingStorageType* theirs = from.getUnderlyingPool(i);
+				if (theirs->exists(source) && !theirs->copyable())
+				{
+					ASSERT_ERROR(false, "Only copy constructible Components can be cloned.");
+					return;
+				}
+			}
+			std::vector<entity_type> targets;
+			targets.reserve(count);
+			entities.reserve(entities.size() + count);
+			for (std::size_t i = 0; i < count; i++)
+			{
+				targets.push_back(createEntity());
+			}
+			for (std::size_t i = 0; i < from.sparseSets.size(); i++)
+			{
+				if (!from.sparseSets[i].initialized || i == relationships) continue;
+				underlyingStorageType* theirs = from.getUnderlyingPool(i);
+				if (!theirs->exists(source)) continue;
+				if (i >= sparseSets.size())
+				{
+					sparseSets.resize(i + 1u);
+				}
+				if (!sparseSets[i].initialized)
+				{
+					sparseSets[i].init();
+					sparseSets[i].sparseSet = theirs->createEmpty();
+					sparseSets[i].sparseSet->setTick(currentTick);
+				}
+				theirs->cloneTo(*getUnderlyingPool(i), source, targets.data(), count);
+				for (entity_type& target : targets) indexInsert(i, target);
+			}
+			std::copy(targets.begin(), targets.end(), out);
+		}
+
+		/*
+		* @brief Returns the Registry this Registry keeps its prefabs in. A prefab is an
+		* ordinary entity of that Registry which is never iterated by views of this one.
+		* Syntax:
+		* Entity bullet = reg.prefabs().createEntity();
+		* reg.prefabs().emplace_back<Velocity>(bullet, 10.0f);
+		* reg.spawn(bullet, 10000, std::back_inserter(wave));
+		*/
+		BasicRegistry& prefabs()
+		{
+			if (prefabRegistry == nullptr)
+			{
+				prefabRegistry = std::make_unique<BasicRegistry>();
+			}
+			return *prefabRegistry;
+		}
+
+		/*
+		* @brief Creates count copies of a prefab in this Registry.
+		* @param prefab is an entity of prefabs().
+		* @param count is the number of copies.
+		* @param out is an output iterator the new entities are written to.
+		* @return void.
+		*/
+		template<typename OutIt>
+		void spawn(entity_type& prefab, std::size_t count, OutIt out)
+		{
+			clone(prefabs(), prefab, count, out);
+		}
+
+		/*
+		* @brief Makes child the first child of parent. Both entities are given a 
+		* Relationship Component if they do not own one yet. If child already had a 
+		* parent it is detached from it first.
+		* @param child is a reference to an instance of Entity.
+		* @param parent is a reference to an instance of Entity.
+		* @return void.
+		*/
+		void setParent(entity_type& child, entity_type& parent)
+		{
+			ASSERT_ERROR(exists(child) && exists(parent), "Entity does not exist.");
+			storageType<relationship_type>* pool = getOrCreatePool<relationship_type>(index<relationship_type>());
+			if (!pool->exists(child)) pool->emplace_back(child);
+			if (!pool->exists(parent)) pool->emplace_back(parent);
+#ifndef NDEBUG
+			for (entity_type ancestor = parent; !isNullEntity(ancestor); ancestor = pool->get(ancestor).parent)
+			{
+				ASSERT_ERROR(ancestor != child, "Setting this parent would create a cycle.");
+			}
+#endif
+			unlinkParent(pool, child);
+			//references are taken after emplacing so they are not invalidated.
+			relationship_type& c = pool->get(child);
+			relationship_type& p = pool->get(parent);
+			c.parent = parent;
+			c.nextSibling = p.firstChild;
+			p.firstChild = child;
+		}
+
+		/*
+		* @brief Detaches e from its parent making it a root. Its children stay attached to it.
+		* @param e is a reference to an instance of Entity.
+		* @return void.
+		*/
+		void removeParent(entity_type& e)
+		{
+			storageType<relationship_type>* pool = tryGetPool<relationship_type>();
+			if (pool == nullptr || !pool->exists(e)) return;
+			unlinkParent(pool, e);
+		}
+
+		/*
+		* @brief Sorts the Relationship pool depth first so every parent is stored before
+		* its children and every subtree is contiguous. After sorting, iterating 
+		* view<Relationship>() visits parents before children, so world transforms can
+		* be propagated in a single linear pass.
+		* @NOTE The order is lost again when Relationship Components are added or removed.
+		* @return void.
+		*/
+		void sortHierarchy()
+		{
+			TENT_PROFILE_SCOPE("Registry::sortHierarchy", this);
+			storageType<relationship_type>* pool = tryGetPool<relationship_type>();
+			if (pool == nullptr) return;
+			std::vector<std::size_t> order;
+			order.reserve(pool->size());
+			for (std::size_t i = 0; i < pool->size(); i++)
+			{
+				entity_type root = pool->at(i);
+				if (!isNullEntity(pool->get_unchecked(root).parent)) continue;
+				//pre order walk that follows the links instead of using a stack.
+				entity_type current = root;
+				while (true)
+				{
+					order.push_back(pool->index_unchecked(current));
+					relationship_type* r = &pool->get_unchecked(current);
+					if (!isNullEntity(r->firstChild))
+					{
+						current = r->firstChild;
+						continue;
+					}
+					while (current != root && isNullEntity(r->nextSibling))
+					{
+						current = r->parent;
+						r = &pool->get_unchecked(current);
+					}
+					if (current == root) break;
+					current = r->nextSibling;
+				}
+			}
+			pool->arrange(order);
 		}
+
 		/*
 		* @brief Removes the specified Component from e.
 		* @tparam Component is the type of Component to remove from e.
@@ -282,9 +1315,20 @@ namespace tent
 		* @return void.
 		*/
 		template<typename Component>
-		void remove(Entity& e)
+		void remove(entity_type& e)
 		{	
-			l_remove(e, index<Component>());
+			TENT_PROFILE_SCOPE("Registry::remove", this);
+			if constexpr (std::is_same_v<Component, relationship_type>)
+			{
+				//keep the parent and siblings from pointing at e once its Relationship is gone.
+				storageType<relationship_type>* relationships = tryGetPool<relationship_type>();
+				if (relationships != nullptr && relationships->exists(e))
+				{
+					unlinkAll(relationships, e);
+				}
+			}
+			indexErase(index<Component>(), e);
+			getUnderlyingPool(index<Component>())->remove(e);
 		}
 
 		/*
@@ -296,11 +1340,11 @@ namespace tent
 		* @return void.
 		*/
 		template<typename FirstComponent, typename SecondComponent, typename... Components>
-		void remove(Entity& e)
+		void remove(entity_type& e)
 		{
 			remove<FirstComponent>(e);
 			remove<SecondComponent>(e);
-			processTList<create_t<Components...>>(e, l_remove);
+			(remove<Components>(e), ...);
 		}
 
 		/*
@@ -322,7 +1366,7 @@ namespace tent
 		* @return if e has the Component return True
 		*/
 		template<typename Component>
-		bool exists(Entity& e)
+		bool exists(entity_type& e)
 		{
 			return getUnderlyingPool(index<Component>())->exists(e);
 		}
@@ -333,7 +1377,7 @@ namespace tent
 		* @param e is a reference an instance of Entity
 		* @return if e is present in the entities unordered_map return true
 		*/
-		bool exists(Entity& e)
+		bool exists(entity_type& e)
 		{
 			return entities.count(e) > 0;
 		}
@@ -350,5 +1394,5 @@ namespace tent
 
 	};
 
+	using Registry = BasicRegistry<Entity>;
 }
-
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <Logi/Logi.h>
+
+#include "View.h"
+
+namespace tent
+{
+	/*
+	* @brief A View whose required and excluded Components are only known at runtime.
+	* It is built from Component ids by Registry::runtime_view and hands out type erased
+	* pointers to the Components along with their size and alignment.
+	*/
+	template<typename E>
+	class RuntimeView
+	{
+	private:
+		using baseStorageType = SparseSet<E>;
+		using entity_type = E;
+		using size_type = std::size_t;
+
+		std::vector<size_type> sparse; // map a Component id to its position in pools.
+		std::vector<baseStorageType*> pools;
+		std::vector<baseStorageType*> excluded; // entities in these pools are skipped.
+		std::vector<entity_type> none; // iterated when a required pool does not exist.
+
+	public:
+		using iterator = ViewIterator<RuntimeView<entity_type>, std::vector<entity_type>>;
+
+	private:
+		baseStorageType* getPool(size_type componentId) const
+		{
+			ASSERT_FATAL(componentId < sparse.size() && sparse[componentId] < pools.size(), "Component id is not part of this view.");
+			return pools[sparse[componentId]];
+		}
+
+	public:
+		RuntimeView() = delete;
+		RuntimeView(std::vector<baseStorageType*> _p, std::vector<size_type> _s, std::vector<baseStorageType*> _e)
+			: sparse(_s), pools(_p), excluded(_e)
+		{
+			if (pools.empty()) return;
+			//set smallest pool at the front of the vector and keep sparse pointing
+			//at the moved pools.
+			size_type smallest = std::min_element(pools.begin(), pools.end(), [](baseStorageType* a, baseStorageType* b) { return *a < *b; }) - pools.begin();
+			std::swap(pools.front(), pools[smallest]);
+			for (size_type& i : sparse)
+			{
+				if (i == 0) i = smallest;
+				else if (i == smallest) i = 0;
+			}
+			//an empty excluded pool can never reject an entity so dont probe it.
+			excluded.erase(std::remove_if(excluded.begin(), excluded.end(), [](baseStorageType* p) { return p->size() == 0; }), excluded.end());
+		}
+
+		/*
+		* @brief Returns a type erased pointer to the Component with id componentId that e owns.
+		* @param componentId is the id of a required Component of this view.
+		* @param e is a reference to an instance of Entity.
+		* @return A pointer to the Component or nullptr if e does not own one.
+		*/
+		void* get(size_type componentId, entity_type& e)
+		{
+			return getPool(componentId)->rawGet(e);
+		}
+
+		/*
+		* @brief Returns sizeof the Component with id componentId.
+		*/
+		size_type componentSize(size_type componentId) const
+		{
+			return getPool(componentId)->componentSize();
+		}
+
+		/*
+		* @brief Returns alignof the Component with id componentId.
+		*/
+		size_type componentAlignment(size_type componentId) const
+		{
+			return getPool(componentId)->componentAlignment();
+		}
+
+		/*
+		* @brief Checks that e is in every required pool and in none of the excluded pools.
+		*/
+		bool exists(entity_type& e) const
+		{
+			for (auto& p : pools)
+			{
+				if (!p->exists(e)) return false;
+			}
+			for (auto& p : excluded)
+			{
+				if (p->exists(e)) return false;
+			}
+			return true;
+		}
+
+		bool empty() const
+		{
+			return pools.empty();
+		}
+
+		/*
+		* @brief Returns an iterator to the smallest pool of entities.
+		* A view without any pools iterates over nothing.
+		*/
+		iterator begin()
+		{
+			if (pools.empty()) return iterator(this, none.begin(), none.end());
+			return iterator(this, pools.front()->begin(), pools.front()->end());
+		}
+
+		iterator end()
+		{
+			if (pools.empty()) return iterator(this, none.end(), none.end());
+			return iterator(this, pools.front()->end(), pools.front()->end());
+		}
+	};
+}
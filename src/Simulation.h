@@ -0,0 +1,302 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Registry.h"
+#include "MemoryStats.h"
+
+/*
+* Defines replacement global operator new and delete that count every allocation
+* for the Simulation report. Place it in exactly one translation unit of the program,
+* without it the allocation columns of the report stay at 0.
+*/
+#define TENT_DEFINE_ALLOCATION_HOOKS() \
+	void* operator new(std::size_t size) \
+	{ \
+		::tent::AllocationCounter::record(size); \
+		if (void* p = std::malloc(size > 0 ? size : 1)) return p; \
+		throw std::bad_alloc(); \
+	} \
+	void operator delete(void* p) noexcept { std::free(p); } \
+	void operator delete(void* p, std::size_t) noexcept { std::free(p); } \
+	static const bool tentAllocationHooksInstalled = ::tent::AllocationCounter::install();
+
+namespace tent
+{
+	/*
+	* @brief Counts heap allocations made through the hooks installed by TENT_DEFINE_ALLOCATION_HOOKS.
+	*/
+	class AllocationCounter
+	{
+	private:
+		static inline std::atomic<std::size_t> allocations{ 0 };
+		static inline std::atomic<std::size_t> allocatedBytes{ 0 };
+		static inline bool installed{ false };
+
+	public:
+		static void record(std::size_t size)
+		{
+			allocations.fetch_add(1, std::memory_order_relaxed);
+			allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		static bool install()
+		{
+			installed = true;
+			return true;
+		}
+
+		static bool isInstalled() { return installed; }
+		static std::size_t count() { return allocations.load(std::memory_order_relaxed); }
+		static std::size_t bytes() { return allocatedBytes.load(std::memory_order_relaxed); }
+	};
+
+	/*
+	* @brief Shape of the world a Simulation runs. Every frame spawnPerFrame entities are
+	* created and killPerFrame random entities are killed before the systems run.
+	*/
+	struct SimulationConfig
+	{
+		std::size_t entities{ 10000 }; // entities created before the first frame.
+		std::size_t frames{ 2000 };
+		std::size_t warmupFrames{ 100 }; // run before frames and left out of the report.
+		std::size_t spawnPerFrame{ 100 };
+		std::size_t killPerFrame{ 100 };
+		uint32_t seed{ 1 };
+	};
+
+	/*
+	* @brief Frame times are in microseconds. Every frame spawns, kills and runs all
+	* systems, the per system times only cover the system itself.
+	*/
+	struct SimulationReport
+	{
+		struct SystemTimes
+		{
+			std::string name;
+			double p50{ 0.0 };
+			double p99{ 0.0 };
+			double max{ 0.0 };
+		};
+
+		std::size_t frames{ 0 };
+		double mean{ 0.0 };
+		double p50{ 0.0 };
+		double p99{ 0.0 };
+		double max{ 0.0 };
+		std::vector<SystemTimes> systems;
+
+		bool allocationsTracked{ false }; // false when TENT_DEFINE_ALLOCATION_HOOKS is not used.
+		std::size_t allocations{ 0 };
+		std::size_t allocatedBytes{ 0 };
+		std::size_t maxFrameAllocations{ 0 };
+
+		std::size_t peakEntities{ 0 };
+		std::size_t peakCapacityBytes{ 0 }; // high water mark of RegistryMemoryStats::capacityBytes.
+
+		/*
+		* @brief Checks whether this run stutters more than baseline did.
+		* @param baseline is the report of a run with the same SimulationConfig.
+		* @param tolerance is the fraction p99 and max may grow by, 0.1 allows 10%.
+		* @return true if p99 or max frame time grew by more than tolerance.
+		*/
+		bool regressed(const SimulationReport& baseline, double tolerance = 0.1) const
+		{
+			return p99 > baseline.p99 * (1.0 + tolerance) || max > baseline.max * (1.0 + tolerance);
+		}
+
+		void write(std::ostream& out) const
+		{
+			out << "frames " << frames << " mean " << mean << "us p50 " << p50 << "us p99 " << p99 << "us max " << max << "us\n";
+			for (const SystemTimes& s : systems)
+			{
+				out << "  " << s.name << " p50 " << s.p50 << "us p99 " << s.p99 << "us max " << s.max << "us\n";
+			}
+			if (allocationsTracked)
+			{
+				out << "allocations " << allocations << " (" << allocatedBytes << " bytes) max per frame " << maxFrameAllocations << "\n";
+			}
+			else
+			{
+				out << "allocations not tracked\n";
+			}
+			out << "peak entities " << peakEntities << " peak capacity " << peakCapacityBytes << " bytes\n";
+		}
+	};
+
+	/*
+	* @brief Runs a Registry through thousands of frames of spawn and kill churn and a set
+	* of systems, and reports the tail of the frame times instead of just the average.
+	* Syntax:
+	* Simulation<Entity> sim(config);
+	* sim.addComponent<Position>(1.0f).addComponent<Velocity>(0.5f);
+	* sim.addSystem("move", [](Registry& reg) { for (auto e : reg.view<Position, Velocity>()) ... });
+	* SimulationReport report = sim.run();
+	*/
+	template<typename E>
+	class Simulation
+	{
+	public:
+		using registry_type = BasicRegistry<E>;
+		using clock = std::chrono::steady_clock;
+
+	private:
+		struct ComponentSpawner
+		{
+			float probability;
+			std::function<void(registry_type&, E&)> emplace;
+		};
+
+		struct System
+		{
+			std::string name;
+			std::function<void(registry_type&)> func;
+		};
+
+		SimulationConfig config;
+		std::vector<ComponentSpawner> spawners;
+		std::vector<System> systems;
+
+		static double elapsed(clock::time_point start, clock::time_point end)
+		{
+			return std::chrono::duration<double, std::micro>(end - start).count();
+		}
+
+		/*
+		* @brief Nearest rank percentile of sorted.
+		*/
+		static double percentile(const std::vector<double>& sorted, double p)
+		{
+			if (sorted.empty()) return 0.0;
+			std::size_t rank = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+			return sorted[rank];
+		}
+
+		void spawn(registry_type& reg, std::vector<E>& alive, std::mt19937& rng)
+		{
+			std::uniform_real_distribution<float> roll(0.0f, 1.0f);
+			E e = reg.createEntity();
+			for (ComponentSpawner& s : spawners)
+			{
+				if (roll(rng) < s.probability) s.emplace(reg, e);
+			}
+			alive.push_back(e);
+		}
+
+		void kill(registry_type& reg, std::vector<E>& alive, std::mt19937& rng)
+		{
+			if (alive.empty()) return;
+			std::size_t i = std::uniform_int_distribution<std::size_t>(0, alive.size() - 1)(rng);
+			reg.kill(alive[i]);
+			alive[i] = alive.back();
+			alive.pop_back();
+		}
+
+	public:
+		Simulation(const SimulationConfig& _config) : config(_config) {}
+
+		/*
+		* @brief Every spawned entity gets a default constructed Component with the given probability.
+		* @tparam Component has to be default constructible.
+		* @param probability is between 0 and 1.
+		* @return A reference to this Simulation so calls can be chained.
+		*/
+		template<typename Component>
+		Simulation& addComponent(float probability)
+		{
+			spawners.push_back({ probability, [](registry_type& reg, E& e) { reg.template emplace_back<Component>(e); } });
+			return *this;
+		}
+
+		/*
+		* @brief Adds a system that runs once per frame in the order systems were added.
+		* @param name is used in the report.
+		* @param func is called as func(registry_type&).
+		* @return A reference to this Simulation so calls can be chained.
+		*/
+		template<typename Func>
+		Simulation& addSystem(const std::string& name, Func&& func)
+		{
+			systems.push_back({ name, std::forward<Func>(func) });
+			return *this;
+		}
+
+		/*
+		* @brief Runs the warmup and measured frames on a fresh Registry.
+		* @return The report of the measured frames.
+		*/
+		SimulationReport run()
+		{
+			registry_type reg;
+			std::mt19937 rng(config.seed);
+			std::vector<E> alive;
+			alive.reserve(config.entities + config.spawnPerFrame);
+			for (std::size_t i = 0; i < config.entities; i++) spawn(reg, alive, rng);
+
+			SimulationReport report;
+			std::vector<double> frameTimes;
+			std::vector<std::vector<double>> systemTimes(systems.size());
+			frameTimes.reserve(config.frames);
+			for (auto& times : systemTimes) times.reserve(config.frames);
+			RegistryMemoryStats stats;
+			std::size_t allocationsBefore = AllocationCounter::count();
+			std::size_t bytesBefore = AllocationCounter::bytes();
+
+			for (std::size_t frame = 0; frame < config.warmupFrames + config.frames; frame++)
+			{
+				bool measured = frame >= config.warmupFrames;
+				if (frame == config.warmupFrames)
+				{
+					allocationsBefore = AllocationCounter::count();
+					bytesBefore = AllocationCounter::bytes();
+				}
+				std::size_t frameAllocations = AllocationCounter::count();
+				clock::time_point start = clock::now();
+				for (std::size_t i = 0; i < config.killPerFrame; i++) kill(reg, alive, rng);
+				for (std::size_t i = 0; i < config.spawnPerFrame; i++) spawn(reg, alive, rng);
+				for (std::size_t i = 0; i < systems.size(); i++)
+				{
+					clock::time_point systemStart = clock::now();
+					systems[i].func(reg);
+					if (measured) systemTimes[i].push_back(elapsed(systemStart, clock::now()));
+				}
+				clock::time_point end = clock::now();
+				if (!measured) continue;
+
+				frameTimes.push_back(elapsed(start, end));
+				report.maxFrameAllocations = std::max(report.maxFrameAllocations, AllocationCounter::count() - frameAllocations);
+				//sampled outside of the frame so it does not count towards the frame time.
+				reg.memoryStats(stats);
+				report.peakCapacityBytes = std::max(report.peakCapacityBytes, stats.capacityBytes());
+				report.peakEntities = std::max(report.peakEntities, stats.entities);
+			}
+
+			report.allocationsTracked = AllocationCounter::isInstalled();
+			report.allocations = AllocationCounter::count() - allocationsBefore;
+			report.allocatedBytes = AllocationCounter::bytes() - bytesBefore;
+			report.frames = frameTimes.size();
+			for (double t : frameTimes) report.mean += t;
+			if (!frameTimes.empty()) report.mean /= static_cast<double>(frameTimes.size());
+			std::sort(frameTimes.begin(), frameTimes.end());
+			report.p50 = percentile(frameTimes, 0.5);
+			report.p99 = percentile(frameTimes, 0.99);
+			report.max = frameTimes.empty() ? 0.0 : frameTimes.back();
+			for (std::size_t i = 0; i < systems.size(); i++)
+			{
+				std::sort(systemTimes[i].begin(), systemTimes[i].end());
+				report.systems.push_back({ systems[i].name, percentile(systemTimes[i], 0.5), percentile(systemTimes[i], 0.99),
+					systemTimes[i].empty() ? 0.0 : systemTimes[i].back() });
+			}
+			return report;
+		}
+	};
+}
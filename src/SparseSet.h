@@ -1,8 +1,14 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
 #include <Logi/Logi.h>
 
 #include "Entity.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
+#include "AccessChecker.h"
 
 namespace tent
 {
@@ -19,57 +25,155 @@ namespace tent
 
 	private:
 		using baseStorageType = SparseSet<E, Container>;
+		using traits_type = typename E::traits_type;
+		//a sparse slot packs the entity's location in the dense array into the index bits
+		//and the entity's generation into the generation bits, so membership needs one load.
+		using slot_type = typename E::entity_type;
+		static constexpr slot_type NULL_SLOT{ traits_type::null_id };
+		static constexpr slot_type GENERATION_BITS{ static_cast<slot_type>(~traits_type::index_mask) };
+
 		uint32_t STARTING_ENTITIES = { 20 };
 		uint32_t DEFAULT_MAX_INDEX = { 256 };
-		std::vector<size_type> sparse; //index = entity.id || value = entity location in dense array
+		std::vector<slot_type> sparse; //index = entity.id || value = entity location in dense array and generation
 		container_type dense; // stores entities
+		size_type peak{ 0 }; // largest size the set has reached.
+		//ticks run parallel to dense and record when each entity was added or last changed.
+		std::vector<uint32_t> addedTicks;
+		std::vector<uint32_t> changedTicks;
+		uint32_t tick{ 0 }; // set by the Registry that owns the set.
+		//optional bit per entity index, set while an entity with that index is in the set.
+		std::vector<uint64_t> bitmap;
+		bool bitmapEnabled{ false };
+#ifdef TENT_ACCESS_CHECKS
+		AccessChecker accessChecker;
+#endif
+
+		static slot_type toSlot(size_type denseI, const value_type& e)
+		{
+			return static_cast<slot_type>(denseI) | (getEntityID(e) & GENERATION_BITS);
+		}
+
+		static size_type slotIndex(slot_type slot)
+		{
+			return static_cast<size_type>(slot & traits_type::index_mask);
+		}
+
+		void setBit(size_type entityIndex)
+		{
+			if (entityIndex / 64u >= bitmap.size()) bitmap.resize(entityIndex / 64u + 1u, 0);
+			bitmap[entityIndex / 64u] |= uint64_t(1) << (entityIndex % 64u);
+		}
+
+		void clearBit(size_type entityIndex)
+		{
+			bitmap[entityIndex / 64u] &= ~(uint64_t(1) << (entityIndex % 64u));
+		}
+
+	protected:
+		/*
+		* @brief Records that the entry at denseI was changed during the current tick.
+		*/
+		void touch(size_type denseI)
+		{
+			changedTicks[denseI] = tick;
+		}
+
+		void touchAll()
+		{
+			std::fill(changedTicks.begin(), changedTicks.end(), tick);
+		}
+
+		/*
+		* @brief Adds count entities to the end of the set, reserving and growing sparse once.
+		* @NOTE None of es can already be in the set.
+		*/
+		void appendEntities(const value_type* es, size_type count)
+		{
+			TENT_PROFILE_SCOPE("Pool::appendEntities", this);
+			TENT_ACCESS_WRITE(accessChecker, "Pool::appendEntities");
+			ASSERT_FATAL(dense.size() + count <= traits_type::index_mask, "More entities than the entity traits can index.");
+			size_type largest{ 0 };
+			for (size_type i = 0; i < count; i++)
+			{
+				if (getEntityIndex(es[i]) > largest) largest = getEntityIndex(es[i]);
+			}
+			if (count > 0 && largest >= sparse.size()) sparse.resize(largest + 1u, NULL_SLOT);
+			dense.reserve(dense.size() + count);
+			for (size_type i = 0; i < count; i++)
+			{
+				ASSERT_ERROR(!exists(const_cast<value_type&>(es[i])), "Entity is already in the set.");
+				dense.push_back(es[i]);
+				sparse[getEntityIndex(es[i])] = toSlot(dense.size() - 1, es[i]);
+				if (bitmapEnabled) setBit(getEntityIndex(es[i]));
+			}
+			addedTicks.resize(dense.size(), tick);
+			changedTicks.resize(dense.size(), tick);
+			if (dense.size() > peak) peak = dense.size();
+		}
 
 	public:
 		SparseSet() 
 		{
 			//have to increase sparse set size to match its capacity for indexing to work
-			sparse.resize(STARTING_ENTITIES, ENTITY_NULL_ID);
+			sparse.resize(STARTING_ENTITIES, NULL_SLOT);
 		}
 
-		~SparseSet() {}
+		virtual ~SparseSet() {}
 
 		/*
 		* @brief Takes in a reference to an instance of Entity, adds it position in
 		* the dense vector to the sparse vector.
 		* @param e is a reference to an instance of Entity.
-		* @return void.
+		* @return false when e is null or its index is already in the set.
 		*/
-		void push(value_type& e)
+		bool push(value_type& e)
 		{
+			TENT_ACCESS_WRITE(accessChecker, "Pool::push");
 			//if entity is not null return false else continue on
-			if (getEntityID(e) == ENTITY_NULL_ID)
+			if (isNullEntity(e))
 			{
 				LOG_WARNING("Attempting to add a null entity.");
-				return;
+				return false;
 			}
 
 			if (getEntityIndex(e) > sparse.size() - 1)
 			{
-				sparse.resize(getEntityIndex(e) + 1u, ENTITY_NULL_ID);
+				sparse.resize(getEntityIndex(e) + 1u, NULL_SLOT);
 			}
 
-			size_type index = sparse.at(getEntityIndex(e));
+			slot_type slot = sparse.at(getEntityIndex(e));
 			//if index is not null check the generation of the entity being added
 			//and the entity at that index.
-			if (index != ENTITY_NULL_ID)
+			if (slot != NULL_SLOT)
 			{
-				ASSERT_FATAL(index < dense.size(), "Index is out of bounds.");
+				ASSERT_FATAL(slotIndex(slot) < dense.size(), "Index is out of bounds.");
 				//if the generations are the same 
 				//the entities are the same so no reason to add it.
-				if (getEntityGeneration(e) == getEntityGeneration(e))
+				if ((slot & GENERATION_BITS) == (getEntityID(e) & GENERATION_BITS))
 				{
 					LOG_WARNING("Attempting to add a duplicate entity.");
-					return;
+					return false;
 				}
+				//an older or newer generation of e was never removed, the index can only hold one.
+				ASSERT_ERROR(false, "Another generation of the entity is already in the set.");
+				LOG_WARNING("Attempting to add an entity whose index is held by another generation.");
+				return false;
 			}
 
+#ifdef TENT_PROFILING
+			size_type capacity = dense.capacity();
+#endif
+			ASSERT_FATAL(dense.size() < traits_type::index_mask, "More entities than the entity traits can index.");
 			dense.push_back(e);
-			sparse[getEntityIndex(e)] = dense.size() - 1;
+			sparse[getEntityIndex(e)] = toSlot(dense.size() - 1, e);
+			if (bitmapEnabled) setBit(getEntityIndex(e));
+			addedTicks.push_back(tick);
+			changedTicks.push_back(tick);
+			if (dense.size() > peak) peak = dense.size();
+#ifdef TENT_PROFILING
+			if (dense.capacity() != capacity) TENT_PROFILE_COUNTER("Pool::capacity", this, static_cast<double>(dense.capacity()));
+#endif
+			return true;
 		}
 
 		/*
@@ -82,14 +186,149 @@ namespace tent
 		virtual void swap(value_type& e, value_type& o, bool sparseSwap = true)
 		{
 			if (e == o) return;
-			size_type& i1 = sparse[getEntityIndex(e)];
-			size_type& i2 = sparse[getEntityIndex(o)];
-			std::swap(get(e), get(o)); //use get(e) here to ensure its a valid reference to the dense vector.
-			std::swap(i1, i2);
+			//e or o can be a reference into dense so copy them before dense is changed.
+			value_type first{ e };
+			value_type second{ o };
+			size_type i1 = slotIndex(sparse[getEntityIndex(first)]);
+			size_type i2 = slotIndex(sparse[getEntityIndex(second)]);
+			std::swap(get(first), get(second)); //use get(e) here to ensure its a valid reference to the dense vector.
+			std::swap(addedTicks[i1], addedTicks[i2]);
+			std::swap(changedTicks[i1], changedTicks[i2]);
+			sparse[getEntityIndex(first)] = toSlot(i2, first);
+			sparse[getEntityIndex(second)] = toSlot(i1, second);
+		}
+
+		/*
+		* @brief Rearranges the dense vector so the entity at order[i] is moved to i
+		* and updates the sparse vector to match.
+		* @param order is a permutation of the indices of the dense vector.
+		*/
+		virtual void arrange(const std::vector<size_type>& order)
+		{
+			TENT_ACCESS_WRITE(accessChecker, "Pool::arrange");
+			ASSERT_ERROR(order.size() == dense.size(), "Order does not match the size of the set.");
+			container_type arranged;
+			std::vector<uint32_t> arrangedAdded;
+			std::vector<uint32_t> arrangedChanged;
+			arranged.reserve(dense.size());
+			arrangedAdded.reserve(dense.size());
+			arrangedChanged.reserve(dense.size());
+			for (size_type i : order)
+			{
+				arranged.push_back(dense[i]);
+				arrangedAdded.push_back(addedTicks[i]);
+				arrangedChanged.push_back(changedTicks[i]);
+			}
+			dense.swap(arranged);
+			addedTicks.swap(arrangedAdded);
+			changedTicks.swap(arrangedChanged);
+			for (size_type i = 0; i < dense.size(); i++)
+			{
+				sparse[getEntityIndex(dense[i])] = toSlot(i, dense[i]);
+			}
+		}
+
+		/*
+		* @brief Creates an empty set of the same type as this one. Used to 
+		* create pools without knowing their Component type.
+		* @return A pointer to the new set.
+		*/
+		virtual std::unique_ptr<baseStorageType> createEmpty() const
+		{
+			return std::make_unique<baseStorageType>();
+		}
+
+		/*
+		* @brief Appends every entity of other to the end of this set in one pass. They are
+		* recorded as added and changed during this set's current tick.
+		* @NOTE None of other's entities can already be in this set. other is left
+		* in a moved from state and has to be discarded afterwards.
+		* @param other is a set of the same type as this one.
+		*/
+		virtual void append(baseStorageType& other)
+		{
+			TENT_PROFILE_SCOPE("Pool::append", this);
+			TENT_ACCESS_WRITE(accessChecker, "Pool::append");
+			dense.reserve(dense.size() + other.dense.size());
+			for (value_type& e : other.dense)
+			{
+				ASSERT_ERROR(!exists(e), "Entity is already in the set.");
+				if (getEntityIndex(e) >= sparse.size())
+				{
+					sparse.resize(getEntityIndex(e) + 1u, NULL_SLOT);
+				}
+				dense.push_back(e);
+				sparse[getEntityIndex(e)] = toSlot(dense.size() - 1, e);
+				if (bitmapEnabled) setBit(getEntityIndex(e));
+			}
+			//other's ticks were counted by another Registry, the entities are added now.
+			addedTicks.resize(dense.size(), tick);
+			changedTicks.resize(dense.size(), tick);
+			if (dense.size() > peak) peak = dense.size();
+		}
+
+		/*
+		* @brief Appends count copies of source to dst under the entities in targets.
+		* Derived classes that store components copy source's component along with it.
+		* dst can be this set.
+		* @NOTE None of targets can already be in dst.
+		* @param dst is a set of the same type as this one.
+		* @param source is an entity in this set.
+		* @param targets points at count entities.
+		* @param count is the number of copies.
+		*/
+		virtual void cloneTo(baseStorageType& dst, value_type& source, const value_type* targets, size_type count)
+		{
+			ASSERT_ERROR(exists(source), "Entity does not exist.");
+			(void)source;
+			dst.appendEntities(targets, count);
+		}
+
+		/*
+		* @brief Returns false when cloneTo can not copy the stored component.
+		*/
+		virtual bool copyable() const
+		{
+			return true;
+		}
+
+		/*
+		* @brief Moves e from this set into dst.
+		* @param dst is a set of the same type as this one.
+		* @param e is a reference to an instance of Entity.
+		*/
+		virtual void moveTo(baseStorageType& dst, value_type& e)
+		{
+			if (!exists(e)) return;
+			value_type temp{ e };
+			dst.push(temp);
+			remove(temp);
+		}
+
+		/*
+		* @brief Moves the entities from position first of the dense vector to the end into
+		* dst in one bulk append. Swapping a selection to the end first moves it out at once.
+		* @NOTE None of the moved entities can already be in dst.
+		* @param dst is a set of the same type as this one.
+		* @param first is the position of the first entity to move.
+		*/
+		virtual void moveTailTo(baseStorageType& dst, size_type first)
+		{
+			TENT_ACCESS_WRITE(accessChecker, "Pool::moveTailTo");
+			dst.appendEntities(dense.data() + first, dense.size() - first);
+			for (size_type i = first; i < dense.size(); i++)
+			{
+				sparse[getEntityIndex(dense[i])] = NULL_SLOT;
+				if (bitmapEnabled) clearBit(getEntityIndex(dense[i]));
+			}
+			dense.erase(dense.begin() + first, dense.end());
+			addedTicks.resize(first);
+			changedTicks.resize(first);
 		}
 
 		virtual void remove(value_type& e)
 		{
+			TENT_ACCESS_WRITE(accessChecker, "Pool::remove");
 			if (!exists(e)) return;
 			//make copy of e be able to set its sparse
 			//index to null.
@@ -97,9 +336,213 @@ namespace tent
 			//call base's swap not Component Storage's swap.
 			baseStorageType::swap(e, last());
 			//set e's index to null id
-			sparse[getEntityIndex(temp)] = ENTITY_NULL_ID;
+			sparse[getEntityIndex(temp)] = NULL_SLOT;
+			if (bitmapEnabled) clearBit(getEntityIndex(temp));
 			//remove e's value
 			dense.pop_back();
+			addedTicks.pop_back();
+			changedTicks.pop_back();
+		}
+
+		/*
+		* @brief Type erased access to the component e owns. SparseSet only stores 
+		* entities so it has no component to return. Derived classes that store 
+		* components override this.
+		* @param e is a reference to an instance of Entity.
+		* @return A pointer to e's component or nullptr.
+		*/
+		virtual void* rawGet(value_type&)
+		{
+			return nullptr;
+		}
+
+		/*
+		* @brief Returns sizeof the stored component or 0 if there is none.
+		*/
+		virtual size_type componentSize() const
+		{
+			return 0;
+		}
+
+		/*
+		* @brief Returns alignof the stored component or 0 if there is none.
+		*/
+		virtual size_type componentAlignment() const
+		{
+			return 0;
+		}
+
+		/*
+		* @brief Removes every entity from the set but keeps all of its allocations.
+		* Only the sparse slots of the entities in the set are reset so the cost
+		* follows the size of the set, not the size of the sparse vector.
+		* Derived classes that store components clear them too.
+		*/
+		virtual void clear()
+		{
+			TENT_ACCESS_WRITE(accessChecker, "Pool::clear");
+			for (value_type& e : dense)
+			{
+				sparse[getEntityIndex(e)] = NULL_SLOT;
+			}
+			std::fill(bitmap.begin(), bitmap.end(), 0);
+			dense.clear();
+			addedTicks.clear();
+			changedTicks.clear();
+		}
+
+		/*
+		* @brief Releases unused capacity of the dense vector and trims the sparse
+		* vector down to the largest entity index still in the set.
+		* Derived classes that store components release their own capacity too.
+		*/
+		virtual void compact()
+		{
+			TENT_ACCESS_WRITE(accessChecker, "Pool::compact");
+			dense.shrink_to_fit();
+			addedTicks.shrink_to_fit();
+			changedTicks.shrink_to_fit();
+			size_type used = STARTING_ENTITIES;
+			for (value_type& e : dense)
+			{
+				if (getEntityIndex(e) + 1u > used) used = getEntityIndex(e) + 1u;
+			}
+			sparse.resize(used, NULL_SLOT);
+			sparse.shrink_to_fit();
+			if (bitmapEnabled)
+			{
+				bitmap.resize(std::min(bitmap.size(), (used + 63u) / 64u));
+				bitmap.shrink_to_fit();
+			}
+		}
+
+		/*
+		* @brief Sets the tick that additions and changes are recorded with.
+		* Called by the Registry when its tick advances.
+		*/
+		void setTick(uint32_t t)
+		{
+			tick = t;
+		}
+
+		uint32_t currentTick() const
+		{
+			return tick;
+		}
+
+		/*
+		* @brief Sets the current tick to t and records every entity in the set as added
+		* and changed during it. Used when a Registry takes over the set from another
+		* Registry whose ticks mean nothing to it.
+		*/
+		void adoptTick(uint32_t t)
+		{
+			tick = t;
+			std::fill(addedTicks.begin(), addedTicks.end(), t);
+			std::fill(changedTicks.begin(), changedTicks.end(), t);
+		}
+
+		/*
+		* @brief Returns the tick e was added to the set in or 0 if e is not in the set.
+		*/
+		uint32_t addedTick(value_type& e)
+		{
+			size_type i = find(e);
+			return i == ENTITY_NULL_ID ? 0 : addedTicks[i];
+		}
+
+		/*
+		* @brief Returns the tick e was last changed in or 0 if e is not in the set.
+		*/
+		uint32_t changedTick(value_type& e)
+		{
+			size_type i = find(e);
+			return i == ENTITY_NULL_ID ? 0 : changedTicks[i];
+		}
+
+		/*
+		* @brief Marks e as changed during the current tick without touching it.
+		* @param e is a reference to an instance of Entity.
+		*/
+		void patch(value_type& e)
+		{
+			size_type i = find(e);
+			if (i != ENTITY_NULL_ID) touch(i);
+		}
+
+		/*
+		* @brief Fills in the entity and sparse vector usage of this set. Derived classes
+		* that store components add their own usage.
+		* @param out is the stats to fill in.
+		*/
+		virtual void memoryStats(PoolMemoryStats& out) const
+		{
+			out.size = dense.size();
+			out.peak = peak;
+			//the ticks are stored per dense entry so they are counted with it.
+			out.denseBytes = dense.size() * (sizeof(value_type) + 2 * sizeof(uint32_t));
+			out.denseCapacityBytes = dense.capacity() * sizeof(value_type) 
+				+ (addedTicks.capacity() + changedTicks.capacity()) * sizeof(uint32_t);
+			//the bitmap is indexed like sparse so it is counted with it.
+			out.sparseBytes = sparse.size() * sizeof(slot_type) + bitmap.size() * sizeof(uint64_t);
+			out.sparseCapacityBytes = sparse.capacity() * sizeof(slot_type) + bitmap.capacity() * sizeof(uint64_t);
+		}
+
+#ifdef TENT_ACCESS_CHECKS
+		/*
+		* @brief Returns the checker that tracks which threads access this set.
+		*/
+		AccessChecker& access()
+		{
+			return accessChecker;
+		}
+#endif
+
+		/*
+		* @brief Starts or stops keeping a bitmap of the entity indices in the set. 
+		* Views intersect the bitmaps of their pools a word at a time instead of probing
+		* every entity when that is cheaper. Costs a bit per entity index and a little
+		* work on every push and remove.
+		* @param enable builds the bitmap from the current entities or frees it.
+		*/
+		void enableBitmap(bool enable)
+		{
+			bitmapEnabled = enable;
+			bitmap.clear();
+			if (!enable)
+			{
+				bitmap.shrink_to_fit();
+				return;
+			}
+			for (value_type& e : dense) setBit(getEntityIndex(e));
+		}
+
+		bool hasBitmap() const
+		{
+			return bitmapEnabled;
+		}
+
+		/*
+		* @brief Returns the words of the bitmap. Bit i of word w is set when an entity
+		* with index w * 64 + i is in the set. Indices past bitmapWords() * 64 are not in the set.
+		*/
+		const uint64_t* bitmapData() const
+		{
+			return bitmap.data();
+		}
+
+		size_type bitmapWords() const
+		{
+			return bitmap.size();
+		}
+
+		/*
+		* @brief Returns the entity in the set with the index entityIndex.
+		* @NOTE Only call this when an entity with that index is known to be in the set.
+		*/
+		value_type& fromIndex(size_type entityIndex)
+		{
+			return dense[slotIndex(sparse[entityIndex])];
 		}
 
 		iterator begin()
@@ -124,29 +567,45 @@ namespace tent
 
 		bool exists(value_type& e)
 		{
-			ENTITY_TYPE entityIndex = getEntityIndex(e);
-			if (entityIndex > sparse.size() - 1)
-			{
-				return false;
-			}
-			if (sparse[entityIndex] == ENTITY_NULL_ID)
+			return find(e) != ENTITY_NULL_ID;
+		}
+
+		/*
+		* @brief Looks up e's position in the dense vector with a single probe
+		* of the sparse vector. The slot holds the generation too so dense is not touched.
+		* @param e is a reference to an instance of Entity.
+		* @return e's index in the dense vector or ENTITY_NULL_ID if e is not in the set.
+		*/
+		size_type find(value_type& e)
+		{
+			size_type entityIndex = getEntityIndex(e);
+			if (entityIndex >= sparse.size())
 			{
-				return false;
+				return ENTITY_NULL_ID;
 			}
-			if (sparse[entityIndex] != ENTITY_NULL_ID)
+			slot_type slot = sparse[entityIndex];
+			if (slot == NULL_SLOT || (slot & GENERATION_BITS) != (getEntityID(e) & GENERATION_BITS))
 			{
-				if (getEntityGeneration(dense[sparse[entityIndex]]) != getEntityGeneration(e))
-				{
-					return false;
-				}
+				return ENTITY_NULL_ID;
 			}
-			return true;
+			return slotIndex(slot);
 		}
 
 		size_type index(value_type& e)
 		{
 			ASSERT_ERROR(exists(e), "Entity does not exist.");
-			return sparse[getEntityIndex(e)];
+			return slotIndex(sparse[getEntityIndex(e)]);
+		}
+
+		/*
+		* @brief Returns e's index in the dense vector without checking that e exists.
+		* @NOTE Only call this when e is known to be in the set.
+		* @param e is a reference to an instance of Entity.
+		* @return e's index in the dense vector.
+		*/
+		size_type index_unchecked(value_type& e)
+		{
+			return slotIndex(sparse[getEntityIndex(e)]);
 		}
 
 		value_type& at(size_type denseI)
@@ -158,7 +617,15 @@ namespace tent
 		value_type& get(value_type& e)
 		{
 			ASSERT_ERROR(exists(e), "Entity does not exist.");
-			return dense[sparse[getEntityIndex(e)]];
+			return dense[slotIndex(sparse[getEntityIndex(e)])];
+		}
+
+		/*
+		* @brief Returns a pointer to the densely packed entities.
+		*/
+		value_type* entityData()
+		{
+			return dense.data();
 		}
 
 		value_type& last()
@@ -0,0 +1,462 @@
+#pragma once
+#include <tuple>
+#include <algorithm>
+#include <vector>
+#include <Logi/Logi.h>
+
+#include "ComponentStorage.h"
+#include "Types.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
+#include "AccessChecker.h"
+#include "View.h"
+
+namespace tent
+{
+	template<typename E, typename Excluded, typename... Components>
+	class StaticView;
+
+	/*
+	* @brief A View over the pools of a BasicStaticRegistry. The pools are known at compile
+	* time so membership checks and component access are direct calls on the concrete pools
+	* and each() inlines the whole loop.
+	* Syntax for (auto e : registry.view<A, B>(exclude<C>)) or registry.view<A, B>().each([](Entity& e, A& a, B& b) {})
+	*/
+	template<typename E, typename... Excluded, typename... Components>
+	class StaticView<E, exclude_t<Excluded...>, Components...>
+	{
+		static_assert(sizeof...(Components) > 0, "A view needs at least one Component.");
+
+	public:
+		using entity_type = E;
+		using iterator = ViewIterator<StaticView, typename SparseSet<E>::container_type>;
+
+	private:
+		template<typename Component>
+		using storageType = ComponentStorage<E, Component>;
+		using baseStorageType = SparseSet<E>;
+
+		std::tuple<storageType<Components>*...> pools;
+		std::tuple<storageType<Excluded>*...> excluded;
+		//the smallest pool, its entities are the ones checked against the rest.
+		baseStorageType* driver;
+#ifdef TENT_ACCESS_CHECKS
+		//the view reads its pools for as long as it lives.
+		std::vector<AccessScope> access;
+#endif
+
+		template<typename Component>
+		storageType<Component>* getPool() const
+		{
+			static_assert(contains_v<Component, Components...>, "Component is not part of the view.");
+			return std::get<storageType<Component>*>(pools);
+		}
+
+	public:
+		StaticView(std::tuple<storageType<Components>*...> _p, std::tuple<storageType<Excluded>*...> _e) : pools(_p), excluded(_e)
+		{
+			driver = std::min({ static_cast<baseStorageType*>(std::get<storageType<Components>*>(pools))... },
+				[](baseStorageType* a, baseStorageType* b) { return a->size() < b->size(); });
+#ifdef TENT_ACCESS_CHECKS
+			access.reserve(sizeof...(Components) + sizeof...(Excluded));
+			(access.emplace_back(std::get<storageType<Components>*>(pools)->access(), false, "StaticView"), ...);
+			(access.emplace_back(std::get<storageType<Excluded>*>(excluded)->access(), false, "StaticView"), ...);
+#endif
+		}
+
+		template<typename Component>
+		Component& get(entity_type& e)
+		{
+			return getPool<Component>()->get(e);
+		}
+
+		/*
+		* @brief Read only access to e's Component. Unlike get it does not mark the
+		* Component as changed.
+		*/
+		template<typename Component>
+		const Component& read(entity_type& e)
+		{
+			return getPool<Component>()->read(e);
+		}
+
+		/*
+		* @brief Checks that e is in every required pool and in none of the excluded pools.
+		*/
+		bool exists(entity_type& e) const
+		{
+			return (std::get<storageType<Components>*>(pools)->exists(e) && ...)
+				&& !(std::get<storageType<Excluded>*>(excluded)->exists(e) || ...);
+		}
+
+		/*
+		* @brief Calls func(entity_type&, Components&...) for every entity in the view.
+		* @NOTE func may not add or remove the view's Components.
+		*/
+		template<typename Func>
+		void each(Func&& func)
+		{
+			TENT_PROFILE_SCOPE("StaticView::each", this);
+			entity_type* entities = driver->entityData();
+			std::size_t size = driver->size();
+			for (std::size_t i = 0; i < size; i++)
+			{
+				entity_type& e = entities[i];
+				if (!exists(e)) continue;
+				func(e, std::get<storageType<Components>*>(pools)->get_unchecked(e)...);
+			}
+		}
+
+		iterator begin()
+		{
+			return iterator(this, driver->begin(), driver->end());
+		}
+
+		iterator end()
+		{
+			return iterator(this, driver->end(), driver->end());
+		}
+	};
+
+	/*
+	* @brief A Registry over a fixed set of Component types. The pools are held by value in a
+	* tuple, so finding a pool is a compile time index, kill visits each pool without going
+	* through a virtual call and views are fully inlined. Mirrors the entity and Component
+	* API of BasicRegistry. Use StaticRegistry<Components...> for the 32 bit Entity.
+	* @tparam E is the entity type.
+	* @tparam Components are every Component type the Registry can hold. Each has to be unique.
+	*/
+	template<typename E, typename... Components>
+	class BasicStaticRegistry
+	{
+	public:
+		using entity_type = E;
+
+	private:
+		template<typename Component>
+		using storageType = ComponentStorage<entity_type, Component>;
+
+		std::tuple<storageType<Components>...> pools;
+		//every entity that is alive.
+		SparseSet<entity_type> entities;
+		//entities to be reused, the lowest index is at the back.
+		std::vector<entity_type> recycleableEntities;
+		std::size_t peakEntities{ 0 };
+		//additions and changes to Components are recorded with this tick.
+		uint32_t currentTick{ 1 };
+
+		template<typename Component>
+		storageType<Component>& pool()
+		{
+			static_assert(contains_v<Component, Components...>, "Component is not part of the StaticRegistry.");
+			return std::get<index_of_v<Component, Components...>>(pools);
+		}
+
+		/*
+		* @brief Removes e from Component's pool. The call is qualified so it does not
+		* go through the virtual table.
+		*/
+		template<typename Component>
+		void removeFrom(entity_type& e)
+		{
+			storageType<Component>& p = pool<Component>();
+			p.storageType<Component>::remove(e);
+		}
+
+	public:
+		BasicStaticRegistry()
+		{
+			(pool<Components>().setTick(currentTick), ...);
+		}
+		BasicStaticRegistry(BasicStaticRegistry&&) = default;
+		BasicStaticRegistry& operator=(BasicStaticRegistry&&) = default;
+
+		/*
+		* @brief Returns an instance of Entity that is either newly created
+		* or an instance that has been recycled from a destroyed Entity.
+		* @return An instance of Entity.
+		*/
+		entity_type createEntity()
+		{
+			//a new id is only drawn from the counter when there is nothing to recycle.
+			entity_type e = recycleableEntities.empty() ? entity_type() : recycleableEntities.back();
+			if (!recycleableEntities.empty()) recycleableEntities.pop_back();
+			entities.push(e);
+			if (entities.size() > peakEntities) peakEntities = entities.size();
+			return e;
+		}
+
+		/*
+		* @brief Removes e from the Registry and from all of the Component pools.
+		* @param e is a reference to an instance of Entity.
+		* @return void.
+		*/
+		void kill(entity_type& e)
+		{
+			TENT_PROFILE_SCOPE("StaticRegistry::kill", this);
+			ASSERT_ERROR(exists(e), "Entity does not exist.");
+			(removeFrom<Components>(e), ...);
+			entity_type temp{ e };
+			entities.remove(temp);
+			recycleableEntities.push_back(temp);
+		}
+
+		/*
+		* @brief Kills every entity and empties every pool while keeping their allocations.
+		* The killed entities are recycled, lowest index first.
+		* @return void.
+		*/
+		void clear()
+		{
+			TENT_PROFILE_SCOPE("StaticRegistry::clear", this);
+			(pool<Components>().clear(), ...);
+			recycleableEntities.insert(recycleableEntities.end(), entities.begin(), entities.end());
+			entities.clear();
+			std::sort(recycleableEntities.begin(), recycleableEntities.end(),
+				[](const entity_type& a, const entity_type& b) { return getEntityIndex(a) > getEntityIndex(b); });
+		}
+
+		/*
+		* @brief Empties the pools of Cs while keeping their allocations. The entities stay alive.
+		* @tparam Cs are the Component types to remove from every entity.
+		* @return void.
+		*/
+		template<typename FirstComponent, typename... Cs>
+		void clear()
+		{
+			pool<FirstComponent>().clear();
+			(pool<Cs>().clear(), ...);
+		}
+
+		/*
+		* @brief Releases memory the pools no longer need. A pool is trimmed when more
+		* than minSlack of its allocated bytes are unused.
+		* @param minSlack is the fraction of unused bytes (0 to 1) a pool needs before it is trimmed.
+		* @return void.
+		*/
+		void compact(float minSlack = 0.0f)
+		{
+			TENT_PROFILE_SCOPE("StaticRegistry::compact", this);
+			auto trim = [minSlack](auto& p)
+			{
+				PoolMemoryStats stats;
+				p.memoryStats(stats);
+				if (stats.slackBytes() > minSlack * stats.capacityBytes()) p.compact();
+			};
+			(trim(pool<Components>()), ...);
+		}
+
+		/*
+		* @brief Fills in the memory used by this Registry and each of its pools.
+		* @param out is the stats to fill in.
+		* @return void.
+		*/
+		void memoryStats(RegistryMemoryStats& out) const
+		{
+			out.pools.clear();
+			auto add = [&out](const auto& p, std::size_t id)
+			{
+				PoolMemoryStats stats;
+				stats.componentId = id;
+				p.memoryStats(stats);
+				out.pools.push_back(stats);
+			};
+			(add(std::get<storageType<Components>>(pools), index_of_v<Components, Components...>), ...);
+			PoolMemoryStats alive;
+			entities.memoryStats(alive);
+			out.entities = entities.size();
+			out.peakEntities = peakEntities;
+			out.recycleableEntities = recycleableEntities.size();
+			out.bookkeepingBytes = alive.capacityBytes() + recycleableEntities.capacity() * sizeof(entity_type);
+		}
+
+		RegistryMemoryStats memoryStats() const
+		{
+			RegistryMemoryStats out;
+			memoryStats(out);
+			return out;
+		}
+
+		/*
+		* @brief Creates a View over every entity that owns all of Cs and none of Excluded.
+		* Syntax registry.view<A, B>(exclude<C, D>)
+		* @tparam Cs are the Component types an entity is required to own.
+		* @tparam Excluded are the Component types an entity is not allowed to own.
+		* @return An instance of StaticView.
+		*/
+		template<typename... Cs, typename... Excluded>
+		StaticView<entity_type, exclude_t<Excluded...>, Cs...> view(exclude_t<Excluded...> = {})
+		{
+			TENT_PROFILE_SCOPE("StaticRegistry::view", this);
+			return StaticView<entity_type, exclude_t<Excluded...>, Cs...>(
+				std::make_tuple(&pool<Cs>()...), std::make_tuple(&pool<Excluded>()...));
+		}
+
+		/*
+		* @brief Returns the tick additions and changes are currently recorded with.
+		*/
+		uint32_t tick() const
+		{
+			return currentTick;
+		}
+
+		/*
+		* @brief Starts a new tick, see BasicRegistry::advanceTick.
+		* @return The new tick.
+		*/
+		uint32_t advanceTick()
+		{
+			currentTick++;
+			(pool<Components>().setTick(currentTick), ...);
+			return currentTick;
+		}
+
+		/*
+		* @brief Marks e's Component as changed during the current tick.
+		*/
+		template<typename Component>
+		void patch(entity_type& e)
+		{
+			TENT_ACCESS_WRITE(pool<Component>().access(), "StaticRegistry::patch");
+			pool<Component>().patch(e);
+		}
+
+		/*
+		* @brief Calls func with e's Component and marks it as changed during the current tick.
+		*/
+		template<typename Component, typename Func>
+		void patch(entity_type& e, Func&& func)
+		{
+			func(get<Component>(e));
+		}
+
+		/*
+		* @brief Returns a const reference to e's Component without marking it as changed.
+		*/
+		template<typename Component>
+		const Component& read(entity_type& e)
+		{
+			TENT_ACCESS_READ(pool<Component>().access(), "StaticRegistry::read");
+			return pool<Component>().read(e);
+		}
+
+		template<typename Component>
+		void push(entity_type& e, Component& c)
+		{
+			push(e, std::move(c));
+		}
+
+		template<typename Component>
+		void push(entity_type& e, Component&& c)
+		{
+			pool<std::decay_t<Component>>().push(e, std::move(c));
+		}
+
+		/*
+		* @brief Constructs a Component from args that will be owned by e.
+		* @tparam Component is the type e will own.
+		* @param e is a reference to an instance of Entity.
+		* @param args are used to create the instance of Component.
+		* @return void.
+		*/
+		template<typename Component, typename ...Args>
+		void emplace_back(entity_type& e, Args&& ... args)
+		{
+			pool<Component>().template emplace_back<Args...>(e, std::forward<Args>(args)...);
+		}
+
+		template<typename Component>
+		Component& get(entity_type& e)
+		{
+			TENT_ACCESS_WRITE(pool<Component>().access(), "StaticRegistry::get");
+			return pool<Component>().get(e);
+		}
+
+		/*
+		* @brief Returns a pointer to the instance of Component that e owns or nullptr
+		* if e does not own one.
+		*/
+		template<typename Component>
+		Component* try_get(entity_type& e)
+		{
+			TENT_ACCESS_WRITE(pool<Component>().access(), "StaticRegistry::try_get");
+			return pool<Component>().try_get(e);
+		}
+
+		template<typename FirstComponent, typename SecondComponent, typename... Cs>
+		std::tuple<FirstComponent&, SecondComponent&, Cs&...> get(entity_type& e)
+		{
+			ASSERT_ERROR(exists(e), "Entity does not exist.");
+			ASSERT_ERROR((exists<FirstComponent>(e) && exists<SecondComponent>(e) && (exists<Cs>(e) && ...)),
+				"Entity does not own all of the requested components.");
+			return std::forward_as_tuple(get_unchecked<FirstComponent>(e), get_unchecked<SecondComponent>(e), get_unchecked<Cs>(e)...);
+		}
+
+		template<typename FirstComponent, typename SecondComponent, typename... Cs>
+		std::tuple<FirstComponent*, SecondComponent*, Cs*...> try_get(entity_type& e)
+		{
+			ASSERT_ERROR(exists(e), "Entity does not exist.");
+			return std::make_tuple(try_get<FirstComponent>(e), try_get<SecondComponent>(e), try_get<Cs>(e)...);
+		}
+
+		/*
+		* @brief Returns a reference to e's Component without checking that e owns one.
+		*/
+		template<typename Component>
+		Component& get_unchecked(entity_type& e)
+		{
+			TENT_ACCESS_WRITE(pool<Component>().access(), "StaticRegistry::get_unchecked");
+			return pool<Component>().get_unchecked(e);
+		}
+
+		/*
+		* @brief Removes Cs from e.
+		* @tparam FirstComponent and Cs are the types of Component to remove from e.
+		* @param e is a reference to an instance of Entity.
+		* @return void.
+		*/
+		template<typename FirstComponent, typename... Cs>
+		void remove(entity_type& e)
+		{
+			TENT_PROFILE_SCOPE("StaticRegistry::remove", this);
+			removeFrom<FirstComponent>(e);
+			(removeFrom<Cs>(e), ...);
+		}
+
+		/*
+		* @brief Returns the position of Component in the Registry's Component list.
+		*/
+		template<typename Component>
+		static constexpr std::size_t index()
+		{
+			return index_of_v<Component, Components...>;
+		}
+
+		template<typename Component>
+		bool exists(entity_type& e)
+		{
+			return pool<Component>().exists(e);
+		}
+
+		bool exists(entity_type& e)
+		{
+			return entities.exists(e);
+		}
+
+		/*
+		* @brief Returns the number of Component pools.
+		*/
+		static constexpr std::size_t size()
+		{
+			return sizeof...(Components);
+		}
+
+		static constexpr bool empty()
+		{
+			return sizeof...(Components) == 0;
+		}
+	};
+
+	template<typename... Components>
+	using StaticRegistry = BasicStaticRegistry<Entity, Components...>;
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <type_traits>
 
 namespace tent
 {
@@ -25,10 +27,110 @@ namespace tent
 	template<typename Component>
 	std::size_t TypeIndex_v = _internal::TypeData<Component>::value();
 
+	namespace _internal
+	{
+		static std::size_t currentQueryId = { 0 };
+
+		template<typename Query>
+		struct QueryData
+		{
+			/*
+			* Takes in a query type and assigns a unique id to it. Kept apart 
+			* from TypeData so queries do not use up Component ids.
+			* Syntax QueryData<type>::id
+			*/
+			static std::size_t value()
+			{
+				static size_t id = currentQueryId++;
+				return id;
+			}
+		};
+	}
+
+	template<typename Query>
+	std::size_t QueryIndex_v = _internal::QueryData<Query>::value();
+
 
 
 	struct null_t {};
 
+	/*
+	* @brief Position of T in the pack Ts, resolved at compile time.
+	* Syntax index_of_v<B, A, B, C> == 1
+	*/
+	template<typename T, typename ... Ts>
+	struct index_of;
+
+	template<typename T, typename ... Ts>
+	struct index_of<T, T, Ts...> : std::integral_constant<std::size_t, 0> {};
+
+	template<typename T, typename U, typename ... Ts>
+	struct index_of<T, U, Ts...> : std::integral_constant<std::size_t, 1 + index_of<T, Ts...>::value> {};
+
+	template<typename T, typename ... Ts>
+	constexpr std::size_t index_of_v = index_of<T, Ts...>::value;
+
+	//true when T is one of Ts.
+	template<typename T, typename ... Ts>
+	constexpr bool contains_v = (std::is_same_v<T, Ts> || ...);
+
+	/*
+	* @brief Tag type that carries the Component types a View should exclude.
+	* Syntax registry.view<A, B>(exclude<C, D>)
+	*/
+	template<typename ... Components>
+	struct exclude_t {};
+
+	template<typename ... Components>
+	constexpr exclude_t<Components...> exclude{};
+
+	/*
+	* @brief Wrap a Component type in a View's Component list to only match entities
+	* whose Component changed (Changed) or was added (Added) after the tick passed to the View.
+	* Syntax registry.view<A, Changed<B>>(lastTick)
+	*/
+	template<typename Component>
+	struct Changed {};
+
+	template<typename Component>
+	struct Added {};
+
+	template<typename T>
+	struct filter_traits
+	{
+		using type = T;
+		static constexpr bool changed = false;
+		static constexpr bool added = false;
+	};
+
+	template<typename Component>
+	struct filter_traits<Changed<Component>>
+	{
+		using type = Component;
+		static constexpr bool changed = true;
+		static constexpr bool added = false;
+	};
+
+	template<typename Component>
+	struct filter_traits<Added<Component>>
+	{
+		using type = Component;
+		static constexpr bool changed = false;
+		static constexpr bool added = true;
+	};
+
+	//the Component type with any Changed or Added wrapper and const removed.
+	template<typename T>
+	using unwrap_t = std::remove_const_t<typename filter_traits<std::remove_const_t<T>>::type>;
+
+	/*
+	* @brief True when a View writes the pool of T. Every Component listed in a View is
+	* written unless it is const, Syntax registry.view<A, const B, Changed<const C>>()
+	* writes A and only reads B and C.
+	*/
+	template<typename T>
+	constexpr bool writes_v = !std::is_const_v<T> && !std::is_const_v<typename filter_traits<std::remove_const_t<T>>::type>;
+
 	template<typename T, typename U>
 	struct Node
 	{
@@ -4,6 +4,14 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <cstdint>
+#include <limits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Profiler.h"
+#include "AccessChecker.h"
 
 namespace tent
 {
@@ -35,7 +43,11 @@ namespace tent
 		using iterator_type = typename Container::iterator;
 		using iterator_category = typename std::forward_iterator_tag;
 
-		ViewIterator(const view_type* _view, iterator_type _start, iterator_type _end) : view(_view), start(_start), end(_end) {}
+		ViewIterator(const view_type* _view, iterator_type _start, iterator_type _end) : view(_view), start(_start), end(_end) 
+		{
+			//the first entity has to pass the same checks as the rest.
+			if (start != end && !view->exists(*start)) ++(*this);
+		}
 	
 		reference operator*() { return *operator->(); }
 		pointer operator->() { return &*start; }
@@ -78,7 +90,34 @@ namespace tent
 		std::vector<entity_type> toRemove;
 		std::vector<std::size_t> sparse; // map TypeData<Component> to its position in pools.
 		std::vector<baseStorageType*> pools;
-		std::vector<entity_type> entities;
+		std::vector<baseStorageType*> excludedPools; // every excluded pool.
+		std::vector<baseStorageType*> excluded; // the non empty excluded pools, entities in these are skipped.
+		std::vector<entity_type> entities; // matches of the bitmap intersection.
+		std::vector<uint64_t> mask; // scratch space for the bitmap intersection.
+		bool useBitmap{ false };
+#ifdef TENT_PROFILING
+		//times the whole life of the view, which covers iterating it.
+		ProfileScope lifetime{ "View", this };
+#endif
+#ifdef TENT_ACCESS_CHECKS
+		//the view reads or writes its pools for as long as it lives.
+		std::vector<AccessScope> access;
+#endif
+
+	public:	
+		/*
+		* @brief Only lets entities through whose entry in pool was added (added == true)
+		* or changed after the view's since tick.
+		*/
+		struct TickFilter
+		{
+			baseStorageType* pool;
+			bool added;
+		};
+
+	private:
+		std::vector<TickFilter> filters;
+		uint32_t since{ 0 };
 
 	public:	
 		using iterator = ViewIterator<View<entity_type>, std::vector<entity_type>>;
@@ -132,6 +171,7 @@ namespace tent
 		*/
 		void removeAll()
 		{
+			TENT_PROFILE_SCOPE("View::removeAll", this);
 			for (entity_type& e : toRemove)
 			{
 				for (std::size_t i = 0; i < pools.size(); i++)
@@ -141,6 +181,122 @@ namespace tent
 			}
 		}
 
+		/*
+		* @brief Makes pools[i] the pool that drives iteration by swapping it to the front
+		* and keeps sparse pointing at the moved pools.
+		*/
+		void setDriver(std::size_t i)
+		{
+			if (i == 0) return;
+			swap(pools.front(), pools[i]);
+			for (std::size_t& s : sparse)
+			{
+				if (s == 0) s = i;
+				else if (s == i) s = 0;
+			}
+		}
+
+		std::size_t smallestPool() const
+		{
+			return std::min_element(pools.begin(), pools.end(), [](baseStorageType* a, baseStorageType* b) { return *a < *b; }) - pools.begin();
+		}
+
+		/*
+		* @brief An empty excluded pool can never reject an entity so it is not probed.
+		* excluded has the capacity for every excluded pool so this does not allocate.
+		*/
+		void filterExcluded()
+		{
+			excluded.clear();
+			for (baseStorageType* p : excludedPools)
+			{
+				if (p->size() != 0) excluded.push_back(p);
+			}
+		}
+
+		static std::size_t countTrailingZeros(uint64_t bits)
+		{
+#ifdef _MSC_VER
+			unsigned long i;
+			_BitScanForward64(&i, bits);
+			return i;
+#else
+			return __builtin_ctzll(bits);
+#endif
+		}
+
+		/*
+		* @brief Picks between probing the other pools for every entity of the smallest pool
+		* and intersecting the bitmaps of the pools that keep one. Probing costs a random load
+		* per pool per entity of the smallest pool. The intersection costs a sequential load 
+		* per bitmap per 64 entity indices, plus the probes of the few entities that match.
+		*/
+		void chooseStrategy()
+		{
+			useBitmap = false;
+			std::size_t bitmaps{ 0 };
+			std::size_t words{ std::numeric_limits<std::size_t>::max() };
+			for (baseStorageType* p : pools)
+			{
+				if (!p->hasBitmap()) continue;
+				bitmaps++;
+				words = std::min(words, p->bitmapWords());
+			}
+			if (bitmaps == 0) return;
+			for (baseStorageType* p : excluded)
+			{
+				if (p->hasBitmap()) bitmaps++;
+			}
+			//a single bitmap does not narrow down anything the smallest pool does not.
+			if (bitmaps < 2) return;
+			std::size_t probes = pools.front()->size() * (pools.size() - 1 + excluded.size());
+			useBitmap = words * bitmaps < probes;
+		}
+
+		/*
+		* @brief ANDs the bitmaps of the required pools, AND-NOTs those of the excluded pools
+		* and collects the entities of the set bits into entities. Each pass runs over whole 
+		* arrays of words so the compiler can vectorize it. The matches still go through
+		* exists when iterated, which checks generations and the pools without a bitmap.
+		* Only called when the strategy is chosen so iterators into entities stay valid.
+		*/
+		void matchBitmaps()
+		{
+			TENT_PROFILE_SCOPE("View::matchBitmaps", this);
+			entities.clear();
+			baseStorageType* source{ nullptr };
+			for (baseStorageType* p : pools)
+			{
+				if (!p->hasBitmap()) continue;
+				const uint64_t* bits = p->bitmapData();
+				if (source == nullptr)
+				{
+					source = p;
+					mask.assign(bits, bits + p->bitmapWords());
+					continue;
+				}
+				std::size_t words = std::min(mask.size(), p->bitmapWords());
+				mask.resize(words);
+				for (std::size_t w = 0; w < words; w++) mask[w] &= bits[w];
+			}
+			for (baseStorageType* p : excluded)
+			{
+				if (!p->hasBitmap()) continue;
+				const uint64_t* bits = p->bitmapData();
+				std::size_t words = std::min(mask.size(), p->bitmapWords());
+				for (std::size_t w = 0; w < words; w++) mask[w] &= ~bits[w];
+			}
+			for (std::size_t w = 0; w < mask.size(); w++)
+			{
+				uint64_t bits = mask[w];
+				while (bits != 0)
+				{
+					entities.push_back(source->fromIndex(w * 64u + countTrailingZeros(bits)));
+					bits &= bits - 1u;
+				}
+			}
+		}
+
 		template<typename Component>
 		storageType<Component>* getPool()
 		{
@@ -157,13 +313,61 @@ namespace tent
 
 	public:
 		View() = delete;
-		View(std::vector<baseStorageType*> _p, std::vector<std::size_t> _s) : pools(_p), sparse(_s)
+		View(std::vector<baseStorageType*> _p, std::vector<std::size_t> _s, std::vector<baseStorageType*> _e = {},
+			std::vector<TickFilter> _f = {}, uint32_t _since = 0, std::vector<baseStorageType*> _w = {})
+			: sparse(_s), pools(_p), excludedPools(_e), filters(_f), since(_since)
 		{
+			TENT_PROFILE_SCOPE("View::View", this);
 			//set smallest pool at the front of the vector.
-			swap(pools.front(), *std::min_element(pools.begin(), pools.end(), [](baseStorageType* a, baseStorageType* b) { return *a < *b; }));
+			setDriver(smallestPool());
+			excluded.reserve(excludedPools.size());
+			filterExcluded();
+			chooseStrategy();
+			if (useBitmap) matchBitmaps();
+#ifdef TENT_ACCESS_CHECKS
+			access.reserve(pools.size() + excludedPools.size());
+			for (baseStorageType* p : pools) access.emplace_back(p->access(), std::find(_w.begin(), _w.end(), p) != _w.end(), "View");
+			for (baseStorageType* p : excludedPools) access.emplace_back(p->access(), false, "View");
+#else
+			(void)_w;
+#endif
 			//rearrange();
 		}
 
+#ifdef TENT_ACCESS_CHECKS
+		/*
+		* @brief Stops the view from counting as a reader or writer of its pools.
+		*/
+		void releaseAccess()
+		{
+			access.clear();
+		}
+#endif
+
+		/*
+		* @brief Prepares a view that is kept across frames for another pass. Entities
+		* passed to remove are removed now, the smallest pool only takes over iteration 
+		* when the current one has grown to more than twice its size and the excluded 
+		* pools are checked for being empty again. The bitmap matches are collected again,
+		* which only allocates when there are more of them than ever before.
+		* @param _since is the tick Changed and Added filters compare against.
+		*/
+		void refresh(uint32_t _since = 0)
+		{
+			since = _since;
+			TENT_PROFILE_SCOPE("View::refresh", this);
+			removeAll();
+			toRemove.clear();
+			std::size_t smallest = smallestPool();
+			if (pools[smallest]->size() * 2 < pools.front()->size())
+			{
+				setDriver(smallest);
+			}
+			filterExcluded();
+			chooseStrategy();
+			if (useBitmap) matchBitmaps();
+		}
+
 		/*
 		* @brief When remove(entity_type e) is called an entity isnt remove then
 		* but placed in the toRemove vector. When the View goes out of scope
@@ -181,6 +385,16 @@ namespace tent
 			return getPool<Component>()->get(e);
 		}
 
+		/*
+		* @brief Read only access to e's Component. Unlike get it does not mark the 
+		* Component as changed.
+		*/
+		template<typename Component>
+		const Component& read(entity_type& e)
+		{
+			return getPool<Component>()->read(e);
+		}
+
 		/*
 		* @brief Removed entities are only added to the toRemove vector where they
 		* will be removed when the View goes out of scope.
@@ -190,20 +404,80 @@ namespace tent
 			toRemove.push_back(e);
 		}
 
+		/*
+		* @brief Checks that e is in every required pool and in none of the excluded pools.
+		*/
 		bool exists(entity_type& e) const
 		{
 			for (auto& p : pools)
 			{
 				if (!p->exists(e)) return false;
 			}
+			for (auto& p : excluded)
+			{
+				if (p->exists(e)) return false;
+			}
+			for (auto& f : filters)
+			{
+				if ((f.added ? f.pool->addedTick(e) : f.pool->changedTick(e)) <= since) return false;
+			}
 			return true;
 		}
 
 		/*
-		* @brief Returns an iterator to the smallest pool of entities.
+		* @brief Walks the view in blocks that point straight into the dense arrays of the pools.
+		* A block is a run of entities that sit next to each other in the smallest pool and in
+		* the pools of every requested Component. A view over a single pool, or over pools
+		* stored in the same order, is handed out in one block per run of matching entities.
+		* Otherwise blocks shrink down to a single entity. A view over a single pool without
+		* excluded Components or tick filters is handed out as one block without checking
+		* any entity.
+		* @tparam Components are the Components to hand out pointers to. They have to be part of the view.
+		* @param func is called as func(const entity_type* entities, Components*... components, std::size_t count).
+		*/
+		template<typename... Components, typename Func>
+		void chunks(Func&& func)
+		{
+			TENT_PROFILE_SCOPE("View::chunks", this);
+			std::tuple<storageType<Components>*...> componentPools{ getPool<Components>()... };
+			baseStorageType* driver = pools.front();
+			entity_type* driverEntities = driver->entityData();
+			std::size_t size = driver->size();
+			if (pools.size() == 1 && excluded.empty() && filters.empty())
+			{
+				//every entity of the pool matches.
+				if (size != 0) func(static_cast<const entity_type*>(driverEntities), std::get<storageType<Components>*>(componentPools)->componentData()..., size);
+				return;
+			}
+			std::size_t i = 0;
+			while (i < size)
+			{
+				if (!exists(driverEntities[i]))
+				{
+					i++;
+					continue;
+				}
+				std::tuple<Components*...> start{ &std::get<storageType<Components>*>(componentPools)->get_unchecked(driverEntities[i])... };
+				std::size_t j = i + 1;
+				while (j < size && exists(driverEntities[j])
+					&& ((&std::get<storageType<Components>*>(componentPools)->get_unchecked(driverEntities[j]) == std::get<Components*>(start) + (j - i)) && ...))
+				{
+					j++;
+				}
+				func(static_cast<const entity_type*>(driverEntities + i), std::get<Components*>(start)..., j - i);
+				i = j;
+			}
+		}
+
+		/*
+		* @brief Returns an iterator to the smallest pool of entities or to the 
+		* matches of the bitmap intersection when that is cheaper. The matches are
+		* collected when the view is created or refreshed, entities added to the pools
+		* after that only show up after the next refresh.
 		*/
 		iterator begin()
 		{
+			if (useBitmap) return iterator(this, entities.begin(), entities.end());
 			return iterator(this, pools.front()->begin(), pools.front()->end());
 		}
 
@@ -215,9 +489,19 @@ namespace tent
 
 		iterator end()
 		{
+			if (useBitmap) return iterator(this, entities.end(), entities.end());
 			return iterator(this, pools.front()->end(), pools.front()->end());
 		}
 
+		/*
+		* @brief Returns true when the view iterates the matches of the pool bitmaps instead
+		* of probing every entity of the smallest pool.
+		*/
+		bool usesBitmap() const
+		{
+			return useBitmap;
+		}
+
 		const_iterator cend() const
 		{
 			static_assert(true == false, "Not implemented yet.");